@@ -0,0 +1,179 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "async_spsc_queue.hpp需要C++20协程支持（-std=c++20）"
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <utility>
+
+#include "spsc_lockfree_queue.hpp"
+
+// 默认唤醒方式：在唤醒方的线程上直接恢复协程
+// 接入调度器时换成把句柄投递到调度器就绪队列的唤醒器，避免在对方的调用栈里运行
+struct InlineResumer {
+    void operator()(std::coroutine_handle<> handle) const {
+        handle.resume();
+    }
+};
+
+// 协程版SPSC队列：co_await pop()在队列空时挂起消费者，co_await push(x)在队列满时挂起生产者，
+// 由对方在下一次成功入队/出队后唤醒
+//
+// 单生产者单消费者，每一端最多只有一个等待者，所以各用一个原子槽位登记协程句柄；
+// awaiter对象存放在协程帧中，co_await本身不分配内存
+//
+// 登记与检查之间的竞争：等待方先写槽位再检查队列，唤醒方先改队列再读槽位，
+// 两边之间各有一个seq_cst栅栏，保证至少一方看到对方的写入；双方都用exchange取走槽位，
+// 句柄只会被恢复一次
+//
+// 登记用release写入槽位，与唤醒方的exchange(acquire)配对，
+// 唤醒方恢复协程时能看到挂起前对协程帧的全部写入（栅栏只负责上面的竞争检查）
+//
+// 句柄写入槽位后协程随时可能在另一线程被恢复，await_suspend之后
+// 只能访问队列对象，不能再访问协程帧中的awaiter
+template<typename T, size_t Size, typename Resumer = InlineResumer>
+class AsyncSPSCQueue {
+private:
+    SPSCLockFreeQueue<T, Size> queue_;
+    
+    alignas(64) std::atomic<void*> consumer_waiter_{nullptr};  // 等待数据的消费者
+    alignas(64) std::atomic<void*> producer_waiter_{nullptr};  // 等待空位的生产者
+    
+    Resumer resumer_;
+    
+    // 对方有等待者时取走并唤醒
+    void wake(std::atomic<void*>& slot) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (slot.load(std::memory_order_relaxed) == nullptr) {
+            return;  // 常见路径：没有等待者，不做原子读改写
+        }
+        void* address = slot.exchange(nullptr, std::memory_order_acquire);
+        if (address != nullptr) {
+            resumer_(std::coroutine_handle<>::from_address(address));
+        }
+    }
+    
+    // 登记等待者后再检查一次条件；条件已满足且槽位未被唤醒方取走时撤销登记，不挂起
+    template<typename Ready>
+    bool register_waiter(std::atomic<void*>& slot, std::coroutine_handle<> handle, Ready&& ready) {
+        slot.store(handle.address(), std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready() && slot.exchange(nullptr, std::memory_order_acq_rel) != nullptr) {
+            return false;
+        }
+        return true;  // 已挂起，或者唤醒方已取走句柄并负责恢复
+    }
+
+public:
+    using value_type = T;
+    
+    class PopAwaiter {
+    private:
+        AsyncSPSCQueue& queue_;
+        T item_{};
+        bool ready_ = false;
+    
+    public:
+        explicit PopAwaiter(AsyncSPSCQueue& queue) : queue_(queue) {}
+        
+        bool await_ready() {
+            ready_ = queue_.try_pop(item_);
+            return ready_;
+        }
+        
+        bool await_suspend(std::coroutine_handle<> handle) {
+            AsyncSPSCQueue* queue = &queue_;
+            return queue->register_waiter(queue->consumer_waiter_, handle,
+                                          [queue]() { return !queue->queue_.empty(); });
+        }
+        
+        T await_resume() {
+            if (!ready_) {
+                // 被唤醒时生产者已经完成入队，单消费者下数据不会被别人取走
+                [[maybe_unused]] bool ok = queue_.try_pop(item_);
+                assert(ok);
+            }
+            return std::move(item_);
+        }
+    };
+    
+    class PushAwaiter {
+    private:
+        AsyncSPSCQueue& queue_;
+        T item_;
+        bool ready_ = false;
+    
+    public:
+        PushAwaiter(AsyncSPSCQueue& queue, T item) : queue_(queue), item_(std::move(item)) {}
+        
+        bool await_ready() {
+            ready_ = queue_.try_push(std::move(item_));  // 失败时item_未被移动
+            return ready_;
+        }
+        
+        bool await_suspend(std::coroutine_handle<> handle) {
+            AsyncSPSCQueue* queue = &queue_;
+            return queue->register_waiter(queue->producer_waiter_, handle,
+                                          [queue]() { return !queue->queue_.full(); });
+        }
+        
+        void await_resume() {
+            if (!ready_) {
+                [[maybe_unused]] bool ok = queue_.try_push(std::move(item_));
+                assert(ok);
+            }
+        }
+    };
+    
+    AsyncSPSCQueue() = default;
+    explicit AsyncSPSCQueue(Resumer resumer) : resumer_(std::move(resumer)) {}
+    
+    // 禁止拷贝和移动（等待者登记的是本对象的地址）
+    AsyncSPSCQueue(const AsyncSPSCQueue&) = delete;
+    AsyncSPSCQueue& operator=(const AsyncSPSCQueue&) = delete;
+    AsyncSPSCQueue(AsyncSPSCQueue&&) = delete;
+    AsyncSPSCQueue& operator=(AsyncSPSCQueue&&) = delete;
+    
+    // 消费者端：co_await queue.pop() 得到下一个元素
+    PopAwaiter pop() {
+        return PopAwaiter(*this);
+    }
+    
+    // 生产者端：co_await queue.push(item)，队列满时挂起直到有空位
+    PushAwaiter push(T item) {
+        return PushAwaiter(*this, std::move(item));
+    }
+    
+    // 非协程的生产者/消费者也可以直接使用，成功后同样唤醒对方
+    template<typename U>
+    bool try_push(U&& item) {
+        if (!queue_.enqueue(std::forward<U>(item))) {
+            return false;
+        }
+        wake(consumer_waiter_);
+        return true;
+    }
+    
+    bool try_pop(T& item) {
+        if (!queue_.dequeue(item)) {
+            return false;
+        }
+        wake(producer_waiter_);
+        return true;
+    }
+    
+    bool empty() const {
+        return queue_.empty();
+    }
+    
+    size_t size() const {
+        return queue_.size();
+    }
+    
+    static constexpr size_t capacity() {
+        return SPSCLockFreeQueue<T, Size>::capacity();
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// 基准程序共用的计数分配器：替换全局operator new/delete（含std::align_val_t重载），
+// 统计开关打开期间的堆分配次数和分配块字节数（含分配器对齐取整，需要glibc）
+//
+// 开关全部关闭时每次分配只多一次relaxed读；只需要次数时不调用malloc_usable_size
+//
+// 本头文件定义了全局operator new/delete，每个可执行文件只能由一个源文件包含
+
+namespace bench_alloc {
+
+enum : unsigned {
+    kCount = 1,  // 统计分配次数
+    kBytes = 2,  // 统计净分配字节数
+};
+
+inline std::atomic<unsigned> g_flags{0};
+inline std::atomic<size_t> g_allocations{0};
+inline std::atomic<int64_t> g_bytes{0};
+
+// 设置统计开关（kCount、kBytes的组合，0为关闭）
+inline void set_tracking(unsigned flags) {
+    g_flags.store(flags, std::memory_order_relaxed);
+}
+
+// 开关打开以来累计的分配次数
+inline size_t allocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+// 开关打开以来的净分配字节数；统计期间分配、统计之外释放的块会使其偏小
+inline int64_t bytes() {
+    return g_bytes.load(std::memory_order_relaxed);
+}
+
+namespace detail {
+
+inline void track(void* ptr, int64_t sign) {
+    const unsigned flags = g_flags.load(std::memory_order_relaxed);
+    if (flags == 0 || !ptr) return;
+    if ((flags & kCount) && sign > 0) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+#ifdef __GLIBC__
+    if (flags & kBytes) {
+        g_bytes.fetch_add(sign * static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    }
+#endif
+}
+
+}  // namespace detail
+}  // namespace bench_alloc
+
+// 不内联：否则编译器在调用点看到malloc与free配对，会误报new/delete不匹配
+__attribute__((noinline)) void* operator new(size_t size) {
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    bench_alloc::detail::track(ptr, 1);
+    return ptr;
+}
+
+__attribute__((noinline)) void* operator new(size_t size, std::align_val_t align) {
+    const size_t alignment = static_cast<size_t>(align);
+    void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!ptr) throw std::bad_alloc();
+    bench_alloc::detail::track(ptr, 1);
+    return ptr;
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+    bench_alloc::detail::track(ptr, -1);
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, std::align_val_t) noexcept {
+    bench_alloc::detail::track(ptr, -1);
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t align) noexcept {
+    operator delete(ptr, align);
+}
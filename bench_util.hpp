@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 各独立基准程序共用的小工具：命令行解析、列表参数、分位数、表格输出和防优化屏障
+
+namespace bench_util {
+
+// 阻止编译器把结果当作无用计算消除（参考Google Benchmark的DoNotOptimize/ClobberMemory）
+template<typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// 可写版本：GCC内联后可能无法满足"+r,m"多选约束，按大小固定选寄存器或内存
+template<typename T>
+inline void do_not_optimize(T& value) {
+    if constexpr (std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(T*)) {
+        asm volatile("" : "+r"(value) : : "memory");
+    } else {
+        asm volatile("" : "+m"(value) : : "memory");
+    }
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+inline int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 模拟每条消息的处理开销
+inline void busy_work(int ns) {
+    if (ns <= 0) return;
+    const int64_t until = steady_now_ns() + ns;
+    while (steady_now_ns() < until) {
+    }
+}
+
+// sorted须已升序排列
+inline double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()))];
+}
+
+// sorted须已升序排列；偶数个样本时取中间两个的平均值
+inline double median(const std::vector<double>& sorted) {
+    if (sorted.empty()) return 0.0;
+    const size_t mid = sorted.size() / 2;
+    return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2.0;
+}
+
+// 逗号分隔的列表，忽略空项
+inline std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    size_t begin = 0;
+    while (begin <= value.size()) {
+        size_t end = value.find(',', begin);
+        if (end == std::string::npos) end = value.size();
+        if (end > begin) {
+            items.push_back(value.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+    return items;
+}
+
+inline std::vector<size_t> parse_size_list(const std::string& value) {
+    std::vector<size_t> result;
+    for (const auto& item : split_list(value)) {
+        result.push_back(std::strtoull(item.c_str(), nullptr, 10));
+    }
+    return result;
+}
+
+inline std::vector<double> parse_double_list(const std::string& value) {
+    std::vector<double> result;
+    for (const auto& item : split_list(value)) {
+        result.push_back(std::strtod(item.c_str(), nullptr));
+    }
+    return result;
+}
+
+inline std::vector<int> parse_int_list(const std::string& value) {
+    std::vector<int> result;
+    for (const auto& item : split_list(value)) {
+        result.push_back(std::atoi(item.c_str()));
+    }
+    return result;
+}
+
+// 逐个解析--key=value形式的参数，handle(key, value)不认识key时返回false
+//
+// 返回-1表示继续运行；否则是main应直接返回的退出码（--help为0，未知参数为1）
+template<typename Handle>
+int parse_args(int argc, char* argv[], void (*print_usage)(const char*), Handle&& handle) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        
+        if (key == "--help" || key == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (!handle(key, value)) {
+            std::cerr << "未知参数: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    return -1;
+}
+
+// 终端显示宽度：中文等3、4字节的UTF-8字符占2列，其余字符占1列
+inline size_t display_width(const std::string& text) {
+    size_t width = 0;
+    for (size_t i = 0; i < text.size();) {
+        const unsigned char lead = static_cast<unsigned char>(text[i]);
+        const size_t bytes = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+        width += bytes >= 3 ? 2 : 1;
+        i += bytes;
+    }
+    return width;
+}
+
+inline void print_rule(size_t width, char c = '=') {
+    std::cout << std::string(width, c) << std::endl;
+}
+
+// 表头：每列按显示宽度补齐到与数据行的setw相同的列数，std::setw按字节数补齐，遇到中文会错位；
+// 宽度为0的列（通常是最后一列）不补齐。同时把std::cout设为左对齐，供后面的数据行使用
+inline void print_header(std::initializer_list<std::pair<const char*, size_t>> columns) {
+    std::cout << std::left;
+    for (const auto& column : columns) {
+        const std::string text = column.first;
+        const size_t width = display_width(text);
+        std::cout << text;
+        if (column.second > width) {
+            std::cout << std::string(column.second - width, ' ');
+        }
+    }
+    std::cout << std::endl;
+}
+
+}  // namespace bench_util
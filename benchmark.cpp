@@ -7,11 +7,37 @@
 #include <functional>
 #include <cmath>
 #include <cstring>
+#include <cstdlib>
 #include <algorithm>
+#include <cctype>
+#include <random>
+#include <stdexcept>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <numeric>
+#include <type_traits>
+#include <new>
+#include <ctime>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
 
 #include "spsc_lockfree_queue.hpp"
 #include "locked_queue.hpp"
 #include "double_buffer_spsc.hpp"
+#include "mpmc_bounded_queue.hpp"
+#include "queue.hpp"
+#include "queue_traits.hpp"
+#include "eventfd_queue.hpp"
+#include "perf_counters.hpp"
+#include "bench_alloc.hpp"
 
 // 测试配置
 struct BenchmarkConfig {
@@ -19,11 +45,51 @@ struct BenchmarkConfig {
     size_t queue_size = 1024;         // 队列大小
     size_t warmup_operations = 10000; // 预热操作次数
     int num_runs = 5;                 // 每个测试运行次数
+    size_t batch_size = 0;            // 双缓冲切换批大小，0表示queue_size/4
+    size_t payload_bytes = 64;        // 消息大小
+    size_t pop_bulk = 1;              // 消费者每次最多出队的元素数，大于1时走批量接口
+    size_t producers = 1;             // 多生产者策略的生产者线程数
+    size_t consumers = 1;             // 多消费者策略的消费者线程数
+    bool collect_perf = false;        // 是否采集硬件性能计数器
+    uint64_t perf_hitm_event = 0;     // HITM原始事件编码，0表示不采集
 };
 
+// 队列容量和消息大小都必须是编译期常量，这里列出可被命令行选择的取值
+template<size_t... Sizes>
+struct SizeList {};
+
+using SupportedCapacities = SizeList<64, 256, 1024, 4096, 16384, 65536>;
+using SupportedPayloads = SizeList<8, 16, 32, 64, 128, 256, 1024, 4096>;
+
+// 将运行时取值分发到对应的模板实例，取值不在列表中时返回false
+template<size_t... Sizes, typename F>
+bool dispatch_size(size_t size, SizeList<Sizes...>, F&& f) {
+    return ((size == Sizes ? (f(std::integral_constant<size_t, Sizes>{}), true) : false) || ...);
+}
+
+template<size_t... Sizes>
+std::string size_list_string(SizeList<Sizes...>) {
+    std::ostringstream oss;
+    const char* sep = "";
+    ((oss << sep << Sizes, sep = " "), ...);
+    return oss.str();
+}
+
 // 性能统计结果
 struct BenchmarkResult {
     std::string name;
+    std::string queue_type;           // 命令行中的队列标识
+    size_t capacity = 0;
+    size_t payload_bytes = 0;
+    size_t num_operations = 0;
+    size_t warmup_operations = 0;
+    size_t batch_size = 0;            // 仅双缓冲有效，其余为0
+    size_t producers = 1;
+    size_t consumers = 1;
+    std::string wait_policy;          // 消费者在队列空时的等待策略，不同策略的结果不可比较
+    int num_runs = 0;
+    double avg_throughput_bytes_per_sec = 0.0;
+    std::vector<double> run_throughputs;
     double avg_throughput_ops_per_sec;
     double avg_latency_ns;
     double min_latency_ns;
@@ -31,6 +97,8 @@ struct BenchmarkResult {
     double p95_latency_ns;
     double p99_latency_ns;
     std::vector<double> latencies;
+    PerfSample perf_per_op;           // 每操作硬件计数（含预热操作）
+    int miscounted_runs = 0;          // 消费者合计出队数不等于num_operations的轮数，非0说明队列丢失或重复了元素
     
     void calculate_stats() {
         if (latencies.empty()) return;
@@ -57,7 +125,7 @@ struct BenchmarkResult {
 class HighResTimer {
 private:
     std::chrono::high_resolution_clock::time_point start_time;
-    
+
 public:
     void start() {
         start_time = std::chrono::high_resolution_clock::now();
@@ -73,99 +141,89 @@ public:
     }
 };
 
-// 测试数据结构
-struct TestData {
+// 测试数据结构：固定大小、可平凡拷贝的消息，覆盖从句柄到大帧的典型流量
+template<size_t Bytes>
+struct Payload {
+    static_assert(Bytes >= 2 * sizeof(uint64_t), "Payload must hold an id and a timestamp");
+    
     uint64_t id;
-    uint64_t timestamp;
-    char padding[48];  // 填充到64字节，避免false sharing
+    std::array<char, Bytes - sizeof(uint64_t)> body;  // 前8字节存时间戳
     
-    TestData() : id(0), timestamp(0) {
-        memset(padding, 0, sizeof(padding));
+    Payload() : id(0), body{} {}
+    
+    // 生产者复用同一条消息，每次只改写头部，避免逐条清零掩盖队列本身的拷贝开销
+    void stamp(uint64_t i, uint64_t ts) {
+        id = i;
+        memcpy(body.data(), &ts, sizeof(ts));
     }
+};
+
+// 8字节消息只有id，没有空间存放时间戳
+template<>
+struct Payload<sizeof(uint64_t)> {
+    uint64_t id;
     
-    TestData(uint64_t i, uint64_t ts) : id(i), timestamp(ts) {
-        memset(padding, 0, sizeof(padding));
+    Payload() : id(0) {}
+    
+    void stamp(uint64_t i, uint64_t) {
+        id = i;
     }
 };
 
-// SPSC无锁队列测试
-BenchmarkResult benchmark_spsc_lockfree(const BenchmarkConfig& config) {
-    BenchmarkResult result;
-    result.name = "SPSC Lock-Free Queue";
+static_assert(sizeof(Payload<8>) == 8 && sizeof(Payload<4096>) == 4096, "Payload must not be padded");
+static_assert(std::is_trivially_copyable<Payload<64>>::value, "Payload must be trivially copyable");
+
+// 在多轮运行间累计硬件计数，最后折算为每操作计数
+// 计数覆盖整个线程生命周期，因此按预热+测试的总操作数折算
+class PerfRecorder {
+private:
+    std::unique_ptr<PerfCounterGroup> group_;
+    PerfSample total_;
+    size_t items_ = 0;
+    bool all_valid_ = true;
+
+public:
+    explicit PerfRecorder(const BenchmarkConfig& config) {
+        if (config.collect_perf) {
+            group_ = std::make_unique<PerfCounterGroup>(config.perf_hitm_event);
+        }
+        total_.values.fill(0.0);
+    }
     
-    std::vector<double> all_latencies;
-    std::vector<double> throughputs;
+    void start() {
+        if (group_) group_->start();
+    }
     
-    for (int run = 0; run < config.num_runs; ++run) {
-        SPSCLockFreeQueue<TestData, 2048> queue;  // 必须是2的幂次
-        std::atomic<bool> producer_done{false};
-        std::atomic<size_t> items_consumed{0};
-        
-        std::vector<double> run_latencies;
-        run_latencies.reserve(config.num_operations);
-        
-        HighResTimer total_timer;
-        
-        // 生产者线程
-        std::thread producer([&]() {
-            HighResTimer timer;
-            
-            // 预热
-            for (size_t i = 0; i < config.warmup_operations; ++i) {
-                TestData data(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
-                while (!queue.enqueue(data)) {
-                    std::this_thread::yield();
-                }
-            }
-            
-            // 实际测试
-            total_timer.start();
-            for (size_t i = 0; i < config.num_operations; ++i) {
-                timer.start();
-                TestData data(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
-                
-                while (!queue.enqueue(data)) {
-                    std::this_thread::yield();
-                }
-                
-                run_latencies.push_back(timer.elapsed_ns());
-            }
-            producer_done.store(true);
-        });
-        
-        // 消费者线程
-        std::thread consumer([&]() {
-            TestData data;
-            size_t consumed = 0;
-            
-            // 预热
-            while (consumed < config.warmup_operations) {
-                if (queue.dequeue(data)) {
-                    consumed++;
-                } else {
-                    std::this_thread::yield();
-                }
-            }
-            
-            // 实际测试
-            consumed = 0;
-            while (!producer_done.load() || !queue.empty()) {
-                if (queue.dequeue(data)) {
-                    consumed++;
-                }
-            }
-            items_consumed.store(consumed);
-        });
-        
-        producer.join();
-        consumer.join();
-        
-        double total_time_ms = total_timer.elapsed_ms();
-        double throughput = (config.num_operations / total_time_ms) * 1000.0;
-        throughputs.push_back(throughput);
-        
-        all_latencies.insert(all_latencies.end(), run_latencies.begin(), run_latencies.end());
+    void stop(size_t items) {
+        if (!group_) return;
+        PerfSample sample = group_->stop();
+        all_valid_ = all_valid_ && sample.valid;
+        for (int event = 0; event < kPerfEventCount; ++event) {
+            total_.values[event] += sample.values[event];
+        }
+        items_ += items;
+    }
+    
+    PerfSample per_op() const {
+        PerfSample result;
+        if (!group_ || !all_valid_ || items_ == 0) return result;
+        for (int event = 0; event < kPerfEventCount; ++event) {
+            result.values[event] = total_.values[event] / items_;
+        }
+        result.valid = true;
+        return result;
     }
+};
+
+// 填充结果中与配置相关的字段，并汇总多轮运行的统计
+template<typename Data>
+void finalize_result(BenchmarkResult& result, const BenchmarkConfig& config,
+                     std::vector<double>&& all_latencies, std::vector<double>&& throughputs) {
+    result.capacity = config.queue_size;
+    result.payload_bytes = sizeof(Data);
+    result.num_operations = config.num_operations;
+    result.warmup_operations = config.warmup_operations;
+    result.num_runs = config.num_runs;
     
     // 计算平均吞吐量
     double sum_throughput = 0.0;
@@ -173,238 +231,349 @@ BenchmarkResult benchmark_spsc_lockfree(const BenchmarkConfig& config) {
         sum_throughput += tp;
     }
     result.avg_throughput_ops_per_sec = sum_throughput / throughputs.size();
+    result.avg_throughput_bytes_per_sec = result.avg_throughput_ops_per_sec * sizeof(Data);
+    result.run_throughputs = std::move(throughputs);
     
     result.latencies = std::move(all_latencies);
     result.calculate_stats();
     
-    return result;
+    // 参数扫描时结果较多，统计完成后释放原始延迟样本
+    result.latencies.clear();
+    result.latencies.shrink_to_fit();
 }
 
-// 有锁队列测试
-BenchmarkResult benchmark_locked_queue(const BenchmarkConfig& config) {
-    BenchmarkResult result;
-    result.name = "Locked Queue";
-    
-    std::vector<double> all_latencies;
-    std::vector<double> throughputs;
-    
-    for (int run = 0; run < config.num_runs; ++run) {
-        LockedQueue<TestData> queue(config.queue_size);
-        std::atomic<bool> producer_done{false};
-        std::atomic<size_t> items_consumed{0};
-        
-        std::vector<double> run_latencies;
-        run_latencies.reserve(config.num_operations);
-        
-        HighResTimer total_timer;
-        
-        // 生产者线程
-        std::thread producer([&]() {
-            HighResTimer timer;
-            
-            // 预热
-            for (size_t i = 0; i < config.warmup_operations; ++i) {
-                TestData data(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
-                while (!queue.enqueue(data)) {
-                    std::this_thread::yield();
-                }
-            }
-            
-            // 实际测试
-            total_timer.start();
-            for (size_t i = 0; i < config.num_operations; ++i) {
-                timer.start();
-                TestData data(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
-                
-                while (!queue.enqueue(data)) {
-                    std::this_thread::yield();
-                }
-                
-                run_latencies.push_back(timer.elapsed_ns());
-            }
-            producer_done.store(true);
+// 默认统计策略不能给队列带来任何开销：钩子为空类型，对象布局与不带统计时相同
+static_assert(std::is_empty<SPSCNoStats::Producer>::value && std::is_empty<SPSCNoStats::Consumer>::value,
+              "disabled stats policy must be empty");
+static_assert(sizeof(SPSCLockFreeQueue<Payload<64>, 1024>) == 2 * 64 + sizeof(Payload<64>) * 1024,
+              "disabled stats policy must not change the queue layout");
+static_assert(sizeof(SPSCLockFreeQueue<Payload<64>, 1024, SPSCQueueStats>) ==
+                  sizeof(SPSCLockFreeQueue<Payload<64>, 1024>),
+              "stats counters must fit in the padded index cache lines");
+
+// 基准测试覆盖的策略组合，与命令行中的队列类型一一对应
+// 加锁队列、双缓冲和序号环的容量在运行时指定，避免按容量重复实例化
+template<typename Data, size_t Capacity>
+using SpscPolicyQueue = Queue<Data, SingleThread, SingleThread, Capacity, HeapStorage, SpinWait>;
+template<typename Data, size_t Capacity>
+using SpscStatsPolicyQueue = Queue<Data, SingleThread, SingleThread, Capacity, HeapStorage, SpinWait, SPSCQueueStats>;
+template<typename Data>
+using LockedPolicyQueue = Queue<Data, MultiThread, MultiThread, kDynamicCapacity, InlineStorage, BlockingWait>;
+template<typename Data>
+using DoubleBufferPolicyQueue = Queue<Data, SingleThread, SingleThread, kDynamicCapacity, DoubleBufferStorage, YieldWait>;
+template<typename Data>
+using MpscPolicyQueue = Queue<Data, MultiThread, SingleThread, kDynamicCapacity, InlineStorage, SpinWait>;
+template<typename Data>
+using MpmcPolicyQueue = Queue<Data, MultiThread, MultiThread, kDynamicCapacity, InlineStorage, SpinWait>;
+
+// 测试函数只通过QueueTraits访问队列，新的策略组合或实现只要满足统一接口即可接入
+static_assert(is_concurrent_queue_v<SpscPolicyQueue<Payload<64>, 1024>> &&
+              is_concurrent_queue_v<SpscStatsPolicyQueue<Payload<64>, 1024>> &&
+              is_concurrent_queue_v<LockedPolicyQueue<Payload<64>>> &&
+              is_concurrent_queue_v<DoubleBufferPolicyQueue<Payload<64>>> &&
+              is_concurrent_queue_v<MpscPolicyQueue<Payload<64>>> &&
+              is_concurrent_queue_v<MpmcPolicyQueue<Payload<64>>>,
+              "benchmarked queues must satisfy the ConcurrentQueue interface");
+static_assert(is_concurrent_queue_v<SPSCLockFreeQueue<Payload<64>, 1024>> &&
+              is_concurrent_queue_v<LockedQueue<Payload<64>>> &&
+              is_concurrent_queue_v<DoubleBufferSPSC<Payload<64>>> &&
+              is_concurrent_queue_v<MPMCBoundedQueue<Payload<64>>>,
+              "queue headers must satisfy the ConcurrentQueue interface");
+
+template<typename T>
+struct TypeTag {
+    using type = T;
+};
+
+// 按队列类型和容量选出策略组合，以TypeTag形式交给调用方构造
+// 各组合的构造参数统一为(容量, 双缓冲批大小)，flush()由生产者在空闲或受阻时调用
+template<typename Data, typename F>
+void dispatch_queue(const std::string& queue_type, size_t capacity, F&& f) {
+    if (queue_type == "locked") {
+        f(TypeTag<LockedPolicyQueue<Data>>{});
+    } else if (queue_type == "double_buffer") {
+        f(TypeTag<DoubleBufferPolicyQueue<Data>>{});
+    } else if (queue_type == "mpsc") {
+        f(TypeTag<MpscPolicyQueue<Data>>{});
+    } else if (queue_type == "mpmc") {
+        f(TypeTag<MpmcPolicyQueue<Data>>{});
+    } else if (queue_type == "spsc_stats") {
+        dispatch_size(capacity, SupportedCapacities{}, [&](auto size) {
+            f(TypeTag<SpscStatsPolicyQueue<Data, decltype(size)::value>>{});
         });
-        
-        // 消费者线程
-        std::thread consumer([&]() {
-            TestData data;
-            size_t consumed = 0;
-            
-            // 预热
-            while (consumed < config.warmup_operations) {
-                if (queue.dequeue(data)) {
-                    consumed++;
-                } else {
-                    std::this_thread::yield();
-                }
-            }
-            
-            // 实际测试
-            consumed = 0;
-            while (!producer_done.load() || !queue.empty()) {
-                if (queue.dequeue(data)) {
-                    consumed++;
-                } else {
-                    std::this_thread::yield();
-                }
-            }
-            items_consumed.store(consumed);
+    } else {
+        dispatch_size(capacity, SupportedCapacities{}, [&](auto size) {
+            f(TypeTag<SpscPolicyQueue<Data, decltype(size)::value>>{});
         });
-        
-        producer.join();
-        consumer.join();
-        
-        double total_time_ms = total_timer.elapsed_ms();
-        double throughput = (config.num_operations / total_time_ms) * 1000.0;
-        throughputs.push_back(throughput);
-        
-        all_latencies.insert(all_latencies.end(), run_latencies.begin(), run_latencies.end());
-    }
-    
-    // 计算平均吞吐量
-    double sum_throughput = 0.0;
-    for (double tp : throughputs) {
-        sum_throughput += tp;
     }
-    result.avg_throughput_ops_per_sec = sum_throughput / throughputs.size();
-    
-    result.latencies = std::move(all_latencies);
-    result.calculate_stats();
-    
-    return result;
 }
 
-// 双缓冲SPSC测试
-BenchmarkResult benchmark_double_buffer(const BenchmarkConfig& config) {
+const char* queue_display_name(const std::string& queue_type) {
+    if (queue_type == "locked") return "Locked Queue";
+    if (queue_type == "double_buffer") return "Double Buffer SPSC";
+    if (queue_type == "spsc_stats") return "SPSC Queue + Stats";
+    if (queue_type == "mpsc") return "MPSC Ring Queue";
+    if (queue_type == "mpmc") return "MPMC Ring Queue";
+    return "SPSC Lock-Free Queue";
+}
+
+bool is_known_queue_type(const std::string& queue_type) {
+    return queue_type == "spsc" || queue_type == "spsc_stats" || queue_type == "locked" ||
+           queue_type == "double_buffer" || queue_type == "mpsc" || queue_type == "mpmc";
+}
+
+// 队列类型当前使用的等待策略名，写入结果并在基线对比时核对
+std::string queue_wait_policy(const std::string& queue_type, size_t capacity) {
+    std::string name;
+    dispatch_queue<Payload<8>>(queue_type, capacity, [&](auto tag) {
+        name = decltype(tag)::type::wait_policy::name();
+    });
+    return name;
+}
+
+// 单个队列类型的吞吐量/延迟测试，对策略矩阵中的每个组合实例化
+// 生产者在队列满时让出CPU，消费者在队列空时按队列的等待策略等待；
+// pop_bulk大于1时消费者批量出队，有原生批量接口的实现整批只同步一次。
+// 多生产者/多消费者策略按config.producers/consumers启动对应数量的线程，操作次数在生产者间均分，
+// 所有生产者预热完成后才开始计时；单生产者/单消费者的一端始终只有一个线程
+template<typename Q, typename Data>
+BenchmarkResult benchmark_queue(const BenchmarkConfig& config, const std::string& queue_type) {
+    static_assert(is_concurrent_queue_v<Q>, "Q must satisfy the ConcurrentQueue interface");
+    using Traits = QueueTraits<Q>;
+    constexpr bool with_stats = !std::is_same<typename Q::stats_policy, SPSCNoStats>::value;
+    const size_t num_producers = Q::kSingleProducer ? 1 : config.producers;
+    const size_t num_consumers = Q::kSingleConsumer ? 1 : config.consumers;
     BenchmarkResult result;
-    result.name = "Double Buffer SPSC";
+    result.name = queue_display_name(queue_type);
+    if (num_producers > 1 || num_consumers > 1) {
+        result.name += " " + std::to_string(num_producers) + "P/" + std::to_string(num_consumers) + "C";
+    }
+    result.queue_type = queue_type;
+    result.producers = num_producers;
+    result.consumers = num_consumers;
+    result.wait_policy = Q::wait_policy::name();
     
     std::vector<double> all_latencies;
     std::vector<double> throughputs;
+    PerfRecorder perf(config);
+    size_t batch_size = 0;
     
     for (int run = 0; run < config.num_runs; ++run) {
-        DoubleBufferSPSC<TestData> queue(config.queue_size);
-        std::atomic<bool> producer_done{false};
+        // 大容量时对象可达数MB，放在堆上避免栈溢出
+        auto queue_ptr = std::make_unique<Q>(config.queue_size, config.batch_size);
+        auto& queue = *queue_ptr;
+        std::atomic<size_t> producers_done{0};
+        std::atomic<size_t> producers_ready{0};
+        std::atomic<size_t> warmup_claimed{0};
         std::atomic<size_t> items_consumed{0};
         
-        std::vector<double> run_latencies;
-        run_latencies.reserve(config.num_operations);
+        std::vector<std::vector<double>> run_latencies(num_producers);
         
         HighResTimer total_timer;
+        perf.start();
         
-        // 生产者线程
-        std::thread producer([&]() {
-            HighResTimer timer;
-            size_t batch_size = config.queue_size / 4;  // 批处理大小
-            
-            // 预热
-            for (size_t i = 0; i < config.warmup_operations; ++i) {
-                TestData data(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
-                while (!queue.enqueue(data)) {
-                    queue.swap_buffers();
-                    std::this_thread::sleep_for(std::chrono::microseconds(1));
-                }
+        // 生产者线程：第p个负责操作区间[begin, end)
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < num_producers; ++p) {
+            producers.emplace_back([&, p]() {
+                HighResTimer timer;
+                Data data;
+                auto& latencies = run_latencies[p];
+                const size_t warmup_begin = config.warmup_operations * p / num_producers;
+                const size_t warmup_end = config.warmup_operations * (p + 1) / num_producers;
+                const size_t begin = config.num_operations * p / num_producers;
+                const size_t end = config.num_operations * (p + 1) / num_producers;
+                latencies.reserve(end - begin);
                 
-                if (i % batch_size == 0) {
-                    queue.swap_buffers();
+                // 预热
+                for (size_t i = warmup_begin; i < warmup_end; ++i) {
+                    data.stamp(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
+                    while (!Traits::try_push(queue, data)) {
+                        queue.flush();
+                        std::this_thread::yield();
+                    }
                 }
-            }
-            
-            // 实际测试
-            total_timer.start();
-            for (size_t i = 0; i < config.num_operations; ++i) {
-                timer.start();
-                TestData data(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
                 
-                while (!queue.enqueue(data)) {
-                    queue.swap_buffers();
-                    std::this_thread::sleep_for(std::chrono::microseconds(1));
+                // 等所有生产者预热完成，由第一个生产者开始计时
+                producers_ready.fetch_add(1);
+                while (producers_ready.load() < num_producers) {
+                    std::this_thread::yield();
+                }
+                if (p == 0) {
+                    total_timer.start();
                 }
                 
-                run_latencies.push_back(timer.elapsed_ns());
+                // 实际测试
+                for (size_t i = begin; i < end; ++i) {
+                    timer.start();
+                    data.stamp(i, std::chrono::high_resolution_clock::now().time_since_epoch().count());
+                    
+                    while (!Traits::try_push(queue, data)) {
+                        queue.flush();
+                        std::this_thread::yield();
+                    }
+                    
+                    latencies.push_back(timer.elapsed_ns());
+                }
                 
-                // 定期切换缓冲区
-                if (i % batch_size == 0) {
-                    queue.swap_buffers();
+                // 确保尚未发布的数据可被消费
+                while (!queue.flushed()) {
+                    queue.flush();
+                    std::this_thread::yield();
                 }
-            }
-            
-            // 最后切换一次确保数据可被消费
-            queue.swap_buffers();
-            producer_done.store(true);
-        });
+                producers_done.fetch_add(1);
+            });
+        }
         
         // 消费者线程
-        std::thread consumer([&]() {
-            TestData data;
-            size_t consumed = 0;
-            
-            // 预热
-            while (consumed < config.warmup_operations) {
-                if (queue.dequeue(data)) {
-                    consumed++;
-                } else {
-                    std::this_thread::yield();
+        std::vector<std::thread> consumers;
+        for (size_t c = 0; c < num_consumers; ++c) {
+            consumers.emplace_back([&]() {
+                Data data;
+                std::vector<Data> bulk(config.pop_bulk);
+                size_t consumed = 0;
+                
+                // 预热：各消费者合计出队warmup_operations个。先用fetch_add领取名额再出队，
+                // 名额领完即停，检查与出队之间被其他消费者插入时也不会多出队
+                while (warmup_claimed.fetch_add(1) < config.warmup_operations) {
+                    while (!Traits::try_pop(queue, data)) {
+                        std::this_thread::yield();
+                    }
                 }
-            }
-            
-            // 实际测试
-            consumed = 0;
-            while (!producer_done.load() || queue.has_data()) {
-                if (queue.dequeue(data)) {
-                    consumed++;
-                } else {
-                    std::this_thread::yield();
+                
+                // 实际测试
+                while (producers_done.load() < num_producers || !queue.empty()) {
+                    size_t n;
+                    if (config.pop_bulk > 1) {
+                        n = Traits::try_pop_bulk(queue, bulk.data(), config.pop_bulk);
+                    } else {
+                        n = Traits::try_pop(queue, data) ? 1 : 0;
+                    }
+                    if (n > 0) {
+                        consumed += n;
+                    } else {
+                        Q::wait_policy::pause();
+                    }
                 }
-            }
-            items_consumed.store(consumed);
-        });
+                items_consumed.fetch_add(consumed);
+            });
+        }
         
-        producer.join();
-        consumer.join();
+        for (auto& t : producers) t.join();
+        for (auto& t : consumers) t.join();
+        perf.stop(config.warmup_operations + config.num_operations);
+        if (items_consumed.load() != config.num_operations) {
+            ++result.miscounted_runs;
+        }
         
         double total_time_ms = total_timer.elapsed_ms();
         double throughput = (config.num_operations / total_time_ms) * 1000.0;
         throughputs.push_back(throughput);
         
-        all_latencies.insert(all_latencies.end(), run_latencies.begin(), run_latencies.end());
+        for (const auto& latencies : run_latencies) {
+            all_latencies.insert(all_latencies.end(), latencies.begin(), latencies.end());
+        }
+        
+        if constexpr (std::is_same<typename Q::backend_type, DoubleBufferBackend<Data>>::value) {
+            batch_size = queue.backend().batch_size();
+        }
+        if constexpr (with_stats) {
+            if (run + 1 == config.num_runs) {
+                SPSCQueueStatsSnapshot stats = queue.snapshot();
+                std::cout << "  统计: 入队 " << stats.enqueued << "，出队 " << stats.dequeued
+                          << "，队列满 " << stats.full_rejections << "，空轮询 " << stats.empty_polls
+                          << "，最大深度 " << stats.max_depth << std::endl;
+            }
+        }
     }
     
-    // 计算平均吞吐量
-    double sum_throughput = 0.0;
-    for (double tp : throughputs) {
-        sum_throughput += tp;
+    result.perf_per_op = perf.per_op();
+    finalize_result<Data>(result, config, std::move(all_latencies), std::move(throughputs));
+    result.batch_size = batch_size;
+    return result;
+}
+
+// 在结果集中查找与参考结果处于同一配置下的指定队列
+const BenchmarkResult* find_peer(const std::vector<BenchmarkResult>& results,
+                                 const BenchmarkResult& ref, const std::string& queue_type) {
+    for (const auto& result : results) {
+        if (result.queue_type == queue_type &&
+            result.capacity == ref.capacity &&
+            result.payload_bytes == ref.payload_bytes &&
+            result.num_operations == ref.num_operations) {
+            return &result;
+        }
     }
-    result.avg_throughput_ops_per_sec = sum_throughput / throughputs.size();
+    return nullptr;
+}
+
+// 打印每操作硬件计数，没有任何结果采集到计数时不输出
+void print_perf_counters(const std::vector<BenchmarkResult>& results) {
+    bool any_valid = std::any_of(results.begin(), results.end(),
+                                 [](const BenchmarkResult& r) { return r.perf_per_op.valid; });
+    if (!any_valid) return;
     
-    result.latencies = std::move(all_latencies);
-    result.calculate_stats();
+    std::cout << "\n硬件计数器（每操作，含预热）" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    std::cout << std::left << std::setw(22) << "队列类型"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "消息(B)"
+              << std::setw(12) << "IPC";
+    for (int event = 0; event < kPerfEventCount; ++event) {
+        std::cout << std::setw(15) << perf_event_name(event);
+    }
+    std::cout << std::endl;
     
-    return result;
+    for (const auto& result : results) {
+        if (!result.perf_per_op.valid) continue;
+        const auto& values = result.perf_per_op.values;
+        
+        std::cout << std::setw(22) << result.name
+                  << std::setw(10) << result.capacity
+                  << std::setw(10) << result.payload_bytes
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << values[kPerfInstructions] / values[kPerfCycles];
+        for (int event = 0; event < kPerfEventCount; ++event) {
+            if (std::isnan(values[event])) {
+                std::cout << std::setw(15) << "-";
+            } else {
+                std::cout << std::setw(15) << std::fixed << std::setprecision(3) << values[event];
+            }
+        }
+        std::cout << std::endl;
+    }
 }
 
 // 打印测试结果
 void print_results(const std::vector<BenchmarkResult>& results) {
-    std::cout << "\n" << std::string(100, '=') << std::endl;
+    std::cout << "\n" << std::string(146, '=') << std::endl;
     std::cout << "队列性能对比测试结果" << std::endl;
-    std::cout << std::string(100, '=') << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
     
     // 表头
     std::cout << std::left;
-    std::cout << std::setw(20) << "队列类型"
+    std::cout << std::setw(22) << "队列类型"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "批大小"
+              << std::setw(10) << "消息(B)"
               << std::setw(15) << "吞吐量(ops/s)"
+              << std::setw(12) << "带宽(MB/s)"
               << std::setw(12) << "平均延迟(ns)"
               << std::setw(12) << "最小延迟(ns)"
               << std::setw(12) << "最大延迟(ns)"
               << std::setw(12) << "P95延迟(ns)"
               << std::setw(12) << "P99延迟(ns)" << std::endl;
     
-    std::cout << std::string(100, '-') << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
     
     // 数据行
     for (const auto& result : results) {
-        std::cout << std::setw(20) << result.name
+        std::cout << std::setw(22) << result.name
+                  << std::setw(10) << result.capacity
+                  << std::setw(10) << result.batch_size
+                  << std::setw(10) << result.payload_bytes
                   << std::setw(15) << std::fixed << std::setprecision(0) << result.avg_throughput_ops_per_sec
+                  << std::setw(12) << std::fixed << std::setprecision(1) << result.avg_throughput_bytes_per_sec / 1e6
                   << std::setw(12) << std::fixed << std::setprecision(1) << result.avg_latency_ns
                   << std::setw(12) << std::fixed << std::setprecision(1) << result.min_latency_ns
                   << std::setw(12) << std::fixed << std::setprecision(1) << result.max_latency_ns
@@ -412,70 +581,2352 @@ void print_results(const std::vector<BenchmarkResult>& results) {
                   << std::setw(12) << std::fixed << std::setprecision(1) << result.p99_latency_ns << std::endl;
     }
     
-    std::cout << std::string(100, '=') << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
     
-    // 性能对比分析
-    if (results.size() >= 2) {
-        std::cout << "\n性能对比分析：" << std::endl;
-        std::cout << std::string(50, '-') << std::endl;
-        
-        const auto& lockfree = results[0];  // SPSC Lock-Free
-        const auto& locked = results[1];    // Locked Queue
-        
-        double throughput_improvement = ((lockfree.avg_throughput_ops_per_sec - locked.avg_throughput_ops_per_sec) 
-                                       / locked.avg_throughput_ops_per_sec) * 100.0;
+    print_perf_counters(results);
+    
+    // 性能对比分析：按相同配置配对，而不是按结果位置
+    bool header_printed = false;
+    for (const auto& lockfree : results) {
+        if (lockfree.queue_type != "spsc") continue;
         
-        double latency_improvement = ((locked.avg_latency_ns - lockfree.avg_latency_ns) 
-                                    / locked.avg_latency_ns) * 100.0;
+        const BenchmarkResult* locked = find_peer(results, lockfree, "locked");
+        const BenchmarkResult* double_buffer = find_peer(results, lockfree, "double_buffer");
+        const BenchmarkResult* with_stats = find_peer(results, lockfree, "spsc_stats");
+        if (!locked && !double_buffer && !with_stats) continue;
         
-        std::cout << "无锁队列 vs 有锁队列：" << std::endl;
-        std::cout << "  吞吐量提升: " << std::fixed << std::setprecision(1) << throughput_improvement << "%" << std::endl;
-        std::cout << "  延迟降低: " << std::fixed << std::setprecision(1) << latency_improvement << "%" << std::endl;
+        if (!header_printed) {
+            std::cout << "\n性能对比分析：" << std::endl;
+            std::cout << std::string(50, '-') << std::endl;
+            header_printed = true;
+        }
+        std::cout << "[容量 " << lockfree.capacity << ", 消息 " << lockfree.payload_bytes << "B]" << std::endl;
         
-        if (results.size() >= 3) {
-            const auto& double_buffer = results[2];  // Double Buffer
+        if (locked) {
+            double throughput_improvement = ((lockfree.avg_throughput_ops_per_sec - locked->avg_throughput_ops_per_sec) 
+                                           / locked->avg_throughput_ops_per_sec) * 100.0;
             
-            double db_throughput_vs_lockfree = ((double_buffer.avg_throughput_ops_per_sec - lockfree.avg_throughput_ops_per_sec) 
+            double latency_improvement = ((locked->avg_latency_ns - lockfree.avg_latency_ns) 
+                                        / locked->avg_latency_ns) * 100.0;
+            
+            std::cout << "无锁队列 vs 有锁队列：" << std::endl;
+            std::cout << "  吞吐量提升: " << std::fixed << std::setprecision(1) << throughput_improvement << "%" << std::endl;
+            std::cout << "  延迟降低: " << std::fixed << std::setprecision(1) << latency_improvement << "%" << std::endl;
+        }
+        
+        if (double_buffer) {
+            double db_throughput_vs_lockfree = ((double_buffer->avg_throughput_ops_per_sec - lockfree.avg_throughput_ops_per_sec) 
                                               / lockfree.avg_throughput_ops_per_sec) * 100.0;
             
-            double db_latency_vs_lockfree = ((lockfree.avg_latency_ns - double_buffer.avg_latency_ns) 
+            double db_latency_vs_lockfree = ((lockfree.avg_latency_ns - double_buffer->avg_latency_ns) 
                                            / lockfree.avg_latency_ns) * 100.0;
             
-            std::cout << "\n双缓冲 vs 无锁队列：" << std::endl;
+            std::cout << "双缓冲 vs 无锁队列：" << std::endl;
             std::cout << "  吞吐量差异: " << std::fixed << std::setprecision(1) << db_throughput_vs_lockfree << "%" << std::endl;
             std::cout << "  延迟差异: " << std::fixed << std::setprecision(1) << db_latency_vs_lockfree << "%" << std::endl;
         }
+        
+        if (with_stats) {
+            double stats_throughput_cost = ((lockfree.avg_throughput_ops_per_sec - with_stats->avg_throughput_ops_per_sec)
+                                          / lockfree.avg_throughput_ops_per_sec) * 100.0;
+            
+            std::cout << "开启统计 vs 无锁队列：" << std::endl;
+            std::cout << "  吞吐量开销: " << std::fixed << std::setprecision(1) << stats_throughput_cost << "%" << std::endl;
+        }
     }
 }
 
-int main() {
-    std::cout << "SPSC队列性能对比测试" << std::endl;
-    std::cout << "正在运行性能测试，请稍等..." << std::endl;
+// JSON字符串转义（结果中的字符串只有名称和类型标识）
+std::string json_escape(const std::string& str) {
+    std::string out;
+    for (char c : str) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// 以JSON数组形式写出结果，便于绘制容量-吞吐量曲线
+bool write_json(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
     
-    BenchmarkConfig config;
-    config.num_operations = 1000000;
-    config.queue_size = 1024;
-    config.warmup_operations = 10000;
-    config.num_runs = 3;
+    out << std::fixed << std::setprecision(1);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << json_escape(r.name) << "\""
+            << ", \"queue\": \"" << json_escape(r.queue_type) << "\""
+            << ", \"capacity\": " << r.capacity
+            << ", \"payload_bytes\": " << r.payload_bytes
+            << ", \"operations\": " << r.num_operations
+            << ", \"warmup\": " << r.warmup_operations
+            << ", \"batch\": " << r.batch_size
+            << ", \"producers\": " << r.producers
+            << ", \"consumers\": " << r.consumers
+            << ", \"wait\": \"" << r.wait_policy << "\""
+            << ", \"runs\": " << r.num_runs
+            << ", \"throughput_ops\": " << r.avg_throughput_ops_per_sec
+            << ", \"throughput_bytes\": " << r.avg_throughput_bytes_per_sec
+            << ", \"avg_ns\": " << r.avg_latency_ns
+            << ", \"min_ns\": " << r.min_latency_ns
+            << ", \"max_ns\": " << r.max_latency_ns
+            << ", \"p95_ns\": " << r.p95_latency_ns
+            << ", \"p99_ns\": " << r.p99_latency_ns;
+        if (r.perf_per_op.valid) {
+            out << ", \"perf_per_op\": {";
+            const char* sep = "";
+            out << std::setprecision(4);
+            for (int event = 0; event < kPerfEventCount; ++event) {
+                if (std::isnan(r.perf_per_op.values[event])) continue;
+                out << sep << "\"" << perf_event_name(event) << "\": " << r.perf_per_op.values[event];
+                sep = ", ";
+            }
+            out << "}" << std::setprecision(1);
+        }
+        out            << ", \"run_throughputs\": [";
+        for (size_t j = 0; j < r.run_throughputs.size(); ++j) {
+            out << (j ? ", " : "") << r.run_throughputs[j];
+        }
+        out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    return static_cast<bool>(out);
+}
+
+// 以CSV形式写出结果，每行一个测试用例
+bool write_csv(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
     
-    std::cout << "\n测试配置：" << std::endl;
-    std::cout << "  操作次数: " << config.num_operations << std::endl;
-    std::cout << "  队列大小: " << config.queue_size << std::endl;
-    std::cout << "  预热操作: " << config.warmup_operations << std::endl;
-    std::cout << "  运行次数: " << config.num_runs << std::endl;
+    out << std::fixed << std::setprecision(1);
+    out << "name,queue,capacity,payload_bytes,operations,batch,producers,consumers,wait,runs,"
+           "throughput_ops,throughput_bytes,avg_ns,min_ns,max_ns,p95_ns,p99_ns";
+    for (int event = 0; event < kPerfEventCount; ++event) {
+        out << ',' << perf_event_name(event) << "_per_op";
+    }
+    out << '\n';
+    for (const auto& r : results) {
+        out << r.name << ',' << r.queue_type << ',' << r.capacity << ','
+            << r.payload_bytes << ',' << r.num_operations << ',' << r.batch_size << ','
+            << r.producers << ',' << r.consumers << ',' << r.wait_policy << ','
+            << r.num_runs << ',' << r.avg_throughput_ops_per_sec << ','
+            << r.avg_throughput_bytes_per_sec << ','
+            << r.avg_latency_ns << ',' << r.min_latency_ns << ',' << r.max_latency_ns << ','
+            << r.p95_latency_ns << ',' << r.p99_latency_ns;
+        // 未采集的计数留空
+        out << std::setprecision(4);
+        for (int event = 0; event < kPerfEventCount; ++event) {
+            out << ',';
+            if (r.perf_per_op.valid && !std::isnan(r.perf_per_op.values[event])) {
+                out << r.perf_per_op.values[event];
+            }
+        }
+        out << std::setprecision(1) << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// 最小JSON读取器，只用于加载本程序写出的结果文件
+struct JsonValue {
+    enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
     
-    std::vector<BenchmarkResult> results;
+    Type type = kNull;
+    bool boolean = false;
+    double number = 0.0;
+    std::string str;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
     
-    std::cout << "\n正在测试 SPSC Lock-Free Queue..." << std::endl;
-    results.push_back(benchmark_spsc_lockfree(config));
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& member : object) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+};
+
+// 语法错误时抛出std::runtime_error
+class JsonParser {
+private:
+    const std::string& text_;
+    size_t pos_ = 0;
     
-    std::cout << "正在测试 Locked Queue..." << std::endl;
-    results.push_back(benchmark_locked_queue(config));
+    void skip_whitespace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
     
-    std::cout << "正在测试 Double Buffer SPSC..." << std::endl;
-    results.push_back(benchmark_double_buffer(config));
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error(what + "（位置 " + std::to_string(pos_) + "）");
+    }
     
-    print_results(results);
+    void expect(char c) {
+        skip_whitespace();
+        if (pos_ >= text_.size() || text_[pos_] != c) {
+            fail(std::string("缺少 '") + c + "'");
+        }
+        ++pos_;
+    }
     
-    return 0;
-} 
\ No newline at end of file
+    bool consume(char c) {
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+    
+    std::string parse_string() {
+        expect('"');
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\') {
+                ++pos_;
+                if (pos_ >= text_.size()) break;
+            }
+            out += text_[pos_++];
+        }
+        if (pos_ >= text_.size()) fail("字符串未结束");
+        ++pos_;
+        return out;
+    }
+    
+    JsonValue parse_value() {
+        skip_whitespace();
+        if (pos_ >= text_.size()) fail("意外的文件结尾");
+        
+        JsonValue value;
+        char c = text_[pos_];
+        if (c == '{') {
+            ++pos_;
+            value.type = JsonValue::kObject;
+            if (consume('}')) return value;
+            do {
+                skip_whitespace();
+                std::string key = parse_string();
+                expect(':');
+                value.object.emplace_back(std::move(key), parse_value());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos_;
+            value.type = JsonValue::kArray;
+            if (consume(']')) return value;
+            do {
+                value.array.push_back(parse_value());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            value.type = JsonValue::kString;
+            value.str = parse_string();
+        } else if (text_.compare(pos_, 4, "true") == 0 || text_.compare(pos_, 5, "false") == 0) {
+            value.type = JsonValue::kBool;
+            value.boolean = text_[pos_] == 't';
+            pos_ += value.boolean ? 4 : 5;
+        } else if (text_.compare(pos_, 4, "null") == 0) {
+            pos_ += 4;
+        } else {
+            const char* begin = text_.c_str() + pos_;
+            char* end = nullptr;
+            value.type = JsonValue::kNumber;
+            value.number = std::strtod(begin, &end);
+            if (end == begin) fail("无法解析的值");
+            pos_ += end - begin;
+        }
+        return value;
+    }
+
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+    
+    JsonValue parse() {
+        JsonValue value = parse_value();
+        skip_whitespace();
+        if (pos_ != text_.size()) fail("多余的内容");
+        return value;
+    }
+};
+
+// 读取write_json写出的结果文件，失败时返回false并给出原因
+bool load_json(const std::string& path, std::vector<BenchmarkResult>& results, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "无法打开文件";
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    
+    try {
+        JsonValue root = JsonParser(text).parse();
+        if (root.type != JsonValue::kArray) {
+            error = "顶层不是数组";
+            return false;
+        }
+        
+        for (const auto& entry : root.array) {
+            auto number = [&](const char* key, double fallback) {
+                const JsonValue* v = entry.find(key);
+                return v && v->type == JsonValue::kNumber ? v->number : fallback;
+            };
+            auto string = [&](const char* key) {
+                const JsonValue* v = entry.find(key);
+                return v && v->type == JsonValue::kString ? v->str : std::string();
+            };
+            
+            BenchmarkResult result;
+            result.name = string("name");
+            result.queue_type = string("queue");
+            result.capacity = static_cast<size_t>(number("capacity", 0));
+            result.payload_bytes = static_cast<size_t>(number("payload_bytes", 64));
+            result.num_operations = static_cast<size_t>(number("operations", 0));
+            result.warmup_operations = static_cast<size_t>(number("warmup", 10000));
+            result.batch_size = static_cast<size_t>(number("batch", 0));
+            result.producers = static_cast<size_t>(number("producers", 1));
+            result.consumers = static_cast<size_t>(number("consumers", 1));
+            result.wait_policy = string("wait");  // 早期版本不记录，为空
+            result.num_runs = static_cast<int>(number("runs", 0));
+            result.avg_throughput_ops_per_sec = number("throughput_ops", 0);
+            
+            if (const JsonValue* runs = entry.find("run_throughputs")) {
+                for (const auto& tp : runs->array) {
+                    result.run_throughputs.push_back(tp.number);
+                }
+            }
+            if (result.queue_type.empty() || result.capacity == 0 || result.num_operations == 0) {
+                error = "条目缺少queue/capacity/operations字段";
+                return false;
+            }
+            results.push_back(std::move(result));
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    return true;
+}
+
+// 基线对比：对每个用例的多轮吞吐量做单侧Mann-Whitney U检验，并用bootstrap估计中位数变化的置信区间
+double median_of(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+// 单侧检验：H1为current的吞吐量整体低于baseline，返回p值
+double mann_whitney_p_lower(const std::vector<double>& baseline, const std::vector<double>& current) {
+    const size_t n = current.size();
+    const size_t m = baseline.size();
+    if (n == 0 || m == 0) return 1.0;
+    
+    // U = current中小于baseline的样本对数，平局计0.5
+    double u = 0.0;
+    for (double x : current) {
+        for (double y : baseline) {
+            if (x < y) u += 1.0;
+            else if (x == y) u += 0.5;
+        }
+    }
+    
+    const size_t max_u = n * m;
+    if (max_u <= 400) {
+        // 小样本用精确分布：ways[i][j][k]为i个current与j个baseline样本排列出U=k的方式数
+        // 按最大元素归属递推：属于current时不贡献样本对，属于baseline时贡献i对
+        std::vector<std::vector<std::vector<double>>> ways(
+            n + 1, std::vector<std::vector<double>>(m + 1, std::vector<double>(max_u + 1, 0.0)));
+        for (size_t i = 0; i <= n; ++i) {
+            for (size_t j = 0; j <= m; ++j) {
+                if (i == 0 || j == 0) {
+                    ways[i][j][0] = 1.0;
+                    continue;
+                }
+                for (size_t k = 0; k <= i * j; ++k) {
+                    ways[i][j][k] = ways[i - 1][j][k] + (k >= i ? ways[i][j - 1][k - i] : 0.0);
+                }
+            }
+        }
+        double total = 0.0;
+        double tail = 0.0;
+        for (size_t k = 0; k <= max_u; ++k) {
+            total += ways[n][m][k];
+            if (static_cast<double>(k) >= u) tail += ways[n][m][k];
+        }
+        return tail / total;
+    }
+    
+    // 大样本用带连续性校正的正态近似
+    double mean = max_u / 2.0;
+    double sigma = std::sqrt(static_cast<double>(n * m * (n + m + 1)) / 12.0);
+    double z = (u - mean - 0.5) / sigma;
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+// 中位数相对变化的bootstrap百分位置信区间（固定种子，结果可复现）
+std::pair<double, double> bootstrap_delta_ci(const std::vector<double>& baseline,
+                                             const std::vector<double>& current,
+                                             double confidence, int iterations = 2000) {
+    std::mt19937 rng(12345);
+    std::vector<double> deltas;
+    deltas.reserve(iterations);
+    std::vector<double> a(baseline.size());
+    std::vector<double> b(current.size());
+    
+    for (int it = 0; it < iterations; ++it) {
+        std::uniform_int_distribution<size_t> pick_a(0, baseline.size() - 1);
+        std::uniform_int_distribution<size_t> pick_b(0, current.size() - 1);
+        for (auto& v : a) v = baseline[pick_a(rng)];
+        for (auto& v : b) v = current[pick_b(rng)];
+        deltas.push_back(median_of(b) / median_of(a) - 1.0);
+    }
+    
+    std::sort(deltas.begin(), deltas.end());
+    double tail = (1.0 - confidence) / 2.0;
+    size_t lo = static_cast<size_t>(tail * (iterations - 1));
+    size_t hi = static_cast<size_t>((1.0 - tail) * (iterations - 1));
+    return {deltas[lo], deltas[hi]};
+}
+
+// 两个结果是否为同一用例
+bool same_case(const BenchmarkResult& a, const BenchmarkResult& b) {
+    return a.queue_type == b.queue_type && a.capacity == b.capacity &&
+           a.payload_bytes == b.payload_bytes && a.num_operations == b.num_operations &&
+           a.batch_size == b.batch_size && a.producers == b.producers && a.consumers == b.consumers &&
+           a.wait_policy == b.wait_policy;
+}
+
+// 打印逐用例对比，返回显著回退的用例数
+// 回退判定：单侧p值不超过alpha，且中位数吞吐量下降超过threshold
+size_t compare_with_baseline(const std::vector<BenchmarkResult>& baseline,
+                             const std::vector<BenchmarkResult>& current,
+                             double threshold, double alpha) {
+    std::cout << "\n" << std::string(146, '=') << std::endl;
+    std::cout << "基线对比（阈值 " << std::fixed << std::setprecision(1) << threshold * 100.0
+              << "%，显著性水平 " << std::setprecision(3) << alpha << "）" << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << std::left << std::setw(22) << "队列类型"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "批大小"
+              << std::setw(10) << "消息(B)"
+              << std::setw(16) << "基线(ops/s)"
+              << std::setw(16) << "当前(ops/s)"
+              << std::setw(12) << "变化"
+              << std::setw(24) << "95%置信区间"
+              << std::setw(10) << "p值"
+              << "结论" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    
+    size_t regressions = 0;
+    for (const auto& base : baseline) {
+        auto it = std::find_if(current.begin(), current.end(),
+                               [&](const BenchmarkResult& r) { return same_case(base, r); });
+        if (it == current.end() || base.run_throughputs.empty() || it->run_throughputs.empty()) continue;
+        
+        double base_median = median_of(base.run_throughputs);
+        double cur_median = median_of(it->run_throughputs);
+        double delta = cur_median / base_median - 1.0;
+        auto ci = bootstrap_delta_ci(base.run_throughputs, it->run_throughputs, 0.95);
+        double p_lower = mann_whitney_p_lower(base.run_throughputs, it->run_throughputs);
+        double p_higher = mann_whitney_p_lower(it->run_throughputs, base.run_throughputs);
+        
+        const char* verdict = "无显著变化";
+        if (p_lower <= alpha && delta < -threshold) {
+            verdict = "回退";
+            ++regressions;
+        } else if (p_higher <= alpha && delta > threshold) {
+            verdict = "提升";
+        }
+        
+        std::ostringstream ci_text;
+        ci_text << std::fixed << std::setprecision(1) << "[" << ci.first * 100.0 << "%, " << ci.second * 100.0 << "%]";
+        
+        std::ostringstream delta_text;
+        delta_text << std::fixed << std::setprecision(1) << std::showpos << delta * 100.0 << "%";
+        
+        std::cout << std::setw(22) << base.name
+                  << std::setw(10) << base.capacity
+                  << std::setw(10) << base.batch_size
+                  << std::setw(10) << base.payload_bytes
+                  << std::setw(16) << std::fixed << std::setprecision(0) << base_median
+                  << std::setw(16) << cur_median
+                  << std::setw(12) << delta_text.str()
+                  << std::setw(24) << ci_text.str()
+                  << std::setw(10) << std::setprecision(4) << std::min(p_lower, p_higher)
+                  << verdict << std::endl;
+    }
+    std::cout << std::string(146, '=') << std::endl;
+    
+    if (baseline.front().run_throughputs.size() < 4) {
+        std::cout << "提示: 每个用例少于4轮时U检验难以达到显著，建议基线和当前都使用 --runs>=5" << std::endl;
+    }
+    return regressions;
+}
+
+// 有序样本的分位数
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(q * sorted.size());
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+// 开环测试配置：生产者按预定发送时刻发送，延迟从预定时刻算起，
+// 队列满导致的发送滞后会计入后续消息的延迟，避免协同遗漏（coordinated omission）
+struct OpenLoopConfig {
+    std::string arrival = "constant";  // constant, poisson, bursty
+    std::vector<double> rates;         // 绝对发送速率(ops/s)，为空时按loads扫描
+    std::vector<double> loads{0.1, 0.3, 0.5, 0.7, 0.9, 1.0, 1.2};  // 相对饱和吞吐量的比例
+    double duty = 0.2;                 // bursty：每个周期中发送的时间占比
+    double period_us = 1000.0;         // bursty：开关周期
+    size_t num_operations = 1000000;
+    int num_runs = 1;
+    size_t batch_size = 0;
+};
+
+struct OpenLoopResult {
+    std::string name;
+    std::string queue_type;
+    size_t capacity = 0;
+    size_t payload_bytes = 0;
+    double offered_rate = 0.0;         // 0表示饱和测量（全部消息预定在起点发送）
+    double achieved_rate = 0.0;
+    double mean_ns = 0.0;
+    double p50_ns = 0.0;
+    double p90_ns = 0.0;
+    double p99_ns = 0.0;
+    double p999_ns = 0.0;
+    double max_ns = 0.0;
+};
+
+// 生成相对起点的预定发送时刻(ns)，rate为0时全部为0
+std::vector<uint64_t> build_schedule(const OpenLoopConfig& config, double rate, std::mt19937_64& rng) {
+    std::vector<uint64_t> schedule(config.num_operations, 0);
+    if (rate <= 0.0) return schedule;
+    
+    const double interval_ns = 1e9 / rate;
+    if (config.arrival == "poisson") {
+        std::exponential_distribution<double> gap(1.0 / interval_ns);
+        double t = 0.0;
+        for (auto& s : schedule) {
+            t += gap(rng);
+            s = static_cast<uint64_t>(t);
+        }
+    } else if (config.arrival == "bursty") {
+        // 开启阶段以rate/duty发送，关闭阶段静默，平均速率仍为rate
+        const double period_ns = config.period_us * 1000.0;
+        const double on_ns = period_ns * config.duty;
+        const double on_interval_ns = interval_ns * config.duty;
+        for (size_t i = 0; i < schedule.size(); ++i) {
+            double on_time = i * on_interval_ns;
+            double cycles = std::floor(on_time / on_ns);
+            schedule[i] = static_cast<uint64_t>(cycles * period_ns + (on_time - cycles * on_ns));
+        }
+    } else {
+        for (size_t i = 0; i < schedule.size(); ++i) {
+            schedule[i] = static_cast<uint64_t>(i * interval_ns);
+        }
+    }
+    return schedule;
+}
+
+uint64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 按给定时刻表跑一轮，延迟样本追加到latencies，返回实际吞吐量
+template<typename Q, typename Data>
+double run_open_loop_once(const std::vector<uint64_t>& schedule, size_t capacity, size_t batch_size,
+                          std::vector<double>& latencies) {
+    auto channel = std::make_unique<Q>(capacity, batch_size);
+    const size_t n = schedule.size();
+    
+    // 留出线程启动时间，两端共享同一个起点
+    const uint64_t start_ns = steady_now_ns() + 1000000;
+    uint64_t last_receive_ns = start_ns;
+    
+    std::thread producer([&]() {
+        Data data;
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t intended = start_ns + schedule[i];
+            while (steady_now_ns() < intended) {
+                channel->flush();
+                std::this_thread::yield();  // 核数不足时让出CPU给消费者
+            }
+            
+            data.stamp(i, intended);
+            while (!channel->try_push(data)) {
+                std::this_thread::yield();
+            }
+        }
+        while (!channel->flushed()) {
+            channel->flush();
+            std::this_thread::yield();
+        }
+    });
+    
+    std::thread consumer([&]() {
+        Data data;
+        size_t received = 0;
+        while (received < n) {
+            if (channel->try_pop(data)) {
+                const uint64_t now = steady_now_ns();
+                latencies.push_back(static_cast<double>(now - (start_ns + schedule[data.id])));
+                last_receive_ns = now;
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    producer.join();
+    consumer.join();
+    
+    return n / ((last_receive_ns - start_ns) / 1e9);
+}
+
+template<typename Q, typename Data>
+OpenLoopResult run_open_loop(const OpenLoopConfig& config, const std::string& queue_type,
+                             size_t capacity, double rate) {
+    OpenLoopResult result;
+    result.name = queue_display_name(queue_type);
+    result.queue_type = queue_type;
+    result.capacity = capacity;
+    result.payload_bytes = sizeof(Data);
+    result.offered_rate = rate;
+    
+    std::mt19937_64 rng(42);
+    std::vector<double> latencies;
+    latencies.reserve(config.num_operations * config.num_runs);
+    double sum_rate = 0.0;
+    for (int run = 0; run < config.num_runs; ++run) {
+        std::vector<uint64_t> schedule = build_schedule(config, rate, rng);
+        sum_rate += run_open_loop_once<Q, Data>(schedule, capacity, config.batch_size, latencies);
+    }
+    result.achieved_rate = sum_rate / config.num_runs;
+    
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0.0;
+    for (double latency : latencies) sum += latency;
+    result.mean_ns = latencies.empty() ? 0.0 : sum / latencies.size();
+    result.p50_ns = percentile(latencies, 0.50);
+    result.p90_ns = percentile(latencies, 0.90);
+    result.p99_ns = percentile(latencies, 0.99);
+    result.p999_ns = percentile(latencies, 0.999);
+    result.max_ns = latencies.empty() ? 0.0 : latencies.back();
+    return result;
+}
+
+// 先测饱和吞吐量，再按比例或绝对速率扫描，得到延迟-吞吐量曲线
+template<typename Data>
+void sweep_open_loop(const OpenLoopConfig& config, const std::string& queue_type, size_t capacity,
+                     std::vector<OpenLoopResult>& results) {
+    dispatch_queue<Data>(queue_type, capacity, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        
+        std::vector<double> rates = config.rates;
+        if (rates.empty()) {
+            std::cout << "\n正在测量饱和吞吐量 " << queue_type << " (容量 " << capacity
+                      << ", 消息 " << sizeof(Data) << "B)..." << std::endl;
+            OpenLoopResult saturation = run_open_loop<Q, Data>(config, queue_type, capacity, 0.0);
+            results.push_back(saturation);
+            for (double load : config.loads) {
+                rates.push_back(load * saturation.achieved_rate);
+            }
+        }
+        
+        for (double rate : rates) {
+            std::cout << "正在测试 " << queue_type << " 目标速率 " << std::fixed << std::setprecision(0)
+                      << rate << " ops/s..." << std::endl;
+            results.push_back(run_open_loop<Q, Data>(config, queue_type, capacity, rate));
+        }
+    });
+}
+
+void print_open_loop_results(const OpenLoopConfig& config, const std::vector<OpenLoopResult>& results) {
+    std::cout << "\n" << std::string(146, '=') << std::endl;
+    std::cout << "开环延迟-吞吐量测试结果（到达模型: " << config.arrival << "，延迟从预定发送时刻算起）" << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << std::left << std::setw(22) << "队列类型"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "消息(B)"
+              << std::setw(15) << "目标(ops/s)"
+              << std::setw(15) << "实际(ops/s)"
+              << std::setw(12) << "平均(ns)"
+              << std::setw(12) << "P50(ns)"
+              << std::setw(12) << "P90(ns)"
+              << std::setw(12) << "P99(ns)"
+              << std::setw(14) << "P99.9(ns)"
+              << std::setw(14) << "最大(ns)" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::setw(22) << r.name
+                  << std::setw(10) << r.capacity
+                  << std::setw(10) << r.payload_bytes;
+        if (r.offered_rate > 0.0) {
+            std::cout << std::setw(15) << std::fixed << std::setprecision(0) << r.offered_rate;
+        } else {
+            std::cout << std::setw(15) << "饱和";
+        }
+        std::cout << std::setw(15) << std::fixed << std::setprecision(0) << r.achieved_rate
+                  << std::setw(12) << std::setprecision(1) << r.mean_ns
+                  << std::setw(12) << r.p50_ns
+                  << std::setw(12) << r.p90_ns
+                  << std::setw(12) << r.p99_ns
+                  << std::setw(14) << r.p999_ns
+                  << std::setw(14) << r.max_ns << std::endl;
+    }
+    std::cout << std::string(146, '=') << std::endl;
+}
+
+bool write_open_loop_json(const std::string& path, const OpenLoopConfig& config,
+                          const std::vector<OpenLoopResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(1);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << json_escape(r.name) << "\""
+            << ", \"queue\": \"" << json_escape(r.queue_type) << "\""
+            << ", \"arrival\": \"" << json_escape(config.arrival) << "\""
+            << ", \"capacity\": " << r.capacity
+            << ", \"payload_bytes\": " << r.payload_bytes
+            << ", \"offered_ops\": " << r.offered_rate
+            << ", \"achieved_ops\": " << r.achieved_rate
+            << ", \"mean_ns\": " << r.mean_ns
+            << ", \"p50_ns\": " << r.p50_ns
+            << ", \"p90_ns\": " << r.p90_ns
+            << ", \"p99_ns\": " << r.p99_ns
+            << ", \"p999_ns\": " << r.p999_ns
+            << ", \"max_ns\": " << r.max_ns
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    return static_cast<bool>(out);
+}
+
+bool write_open_loop_csv(const std::string& path, const OpenLoopConfig& config,
+                         const std::vector<OpenLoopResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(1);
+    out << "name,queue,arrival,capacity,payload_bytes,offered_ops,achieved_ops,"
+           "mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+    for (const auto& r : results) {
+        out << r.name << ',' << r.queue_type << ',' << config.arrival << ','
+            << r.capacity << ',' << r.payload_bytes << ',' << r.offered_rate << ','
+            << r.achieved_rate << ',' << r.mean_ns << ',' << r.p50_ns << ','
+            << r.p90_ns << ',' << r.p99_ns << ',' << r.p999_ns << ',' << r.max_ns << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// 流水线测试配置：源线程 -> 第1级 -> ... -> 第K级，相邻两级之间一个队列（K跳）
+// 每级对每条消息执行一段合成计算，最后一级同时作为终点统计端到端延迟
+struct PipelineConfig {
+    std::vector<size_t> stage_counts{1, 2, 4};
+    std::vector<double> work_ns{0.0};  // 各级合成计算耗时，按级循环取值
+    double rate = 0.0;                 // 源端发送速率，0表示尽力发送
+    size_t num_operations = 1000000;
+    size_t batch_size = 0;
+};
+
+struct PipelineResult {
+    std::string name;
+    std::string queue_type;
+    size_t stages = 0;
+    size_t capacity = 0;
+    size_t payload_bytes = 0;
+    double throughput = 0.0;                 // 终点实际吞吐量
+    double e2e_mean_ns = 0.0;
+    double e2e_p50_ns = 0.0;
+    double e2e_p99_ns = 0.0;
+    double e2e_p999_ns = 0.0;
+    std::vector<double> hop_mean_ns;         // 每跳（上一级发出到本级收到）的平均延迟
+    std::vector<double> stage_capacity;      // 每级忙碌时间折算出的处理能力(ops/s)
+    size_t bottleneck_stage = 0;             // 处理能力最低的级（从1开始）
+};
+
+// 忙等指定时长，模拟每级的处理开销
+void spin_for_ns(double ns) {
+    if (ns <= 0.0) return;
+    const uint64_t until = steady_now_ns() + static_cast<uint64_t>(ns);
+    while (steady_now_ns() < until) {
+    }
+}
+
+template<typename Q, typename Data>
+PipelineResult run_pipeline(const PipelineConfig& config, const std::string& queue_type,
+                            size_t capacity, size_t stages) {
+    const size_t n = config.num_operations;
+    
+    std::vector<std::unique_ptr<Q>> channels;
+    for (size_t s = 0; s < stages; ++s) {
+        channels.push_back(std::make_unique<Q>(capacity, config.batch_size));
+    }
+    
+    // 按消息id记录上一跳的发出时刻和源端发送时刻，写入发生在入队之前，由队列的同步保证可见性
+    std::vector<uint64_t> sent_ns(n);
+    std::vector<uint64_t> forwarded_ns(n);
+    std::vector<std::vector<double>> hop_latencies(stages, std::vector<double>());
+    std::vector<double> busy_ns(stages, 0.0);
+    std::vector<double> e2e_latencies;
+    e2e_latencies.reserve(n);
+    for (auto& hop : hop_latencies) hop.reserve(n);
+    
+    const uint64_t start_ns = steady_now_ns() + 1000000;
+    uint64_t last_receive_ns = start_ns;
+    
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        Data data;
+        Q& out = *channels.front();
+        const double interval_ns = config.rate > 0.0 ? 1e9 / config.rate : 0.0;
+        while (steady_now_ns() < start_ns) {
+        }
+        for (size_t i = 0; i < n; ++i) {
+            // 限速时延迟从预定发送时刻算起，避免协同遗漏
+            uint64_t now = steady_now_ns();
+            if (interval_ns > 0.0) {
+                const uint64_t intended = start_ns + static_cast<uint64_t>(i * interval_ns);
+                while (now < intended) {
+                    out.flush();
+                    std::this_thread::yield();
+                    now = steady_now_ns();
+                }
+                now = intended;
+            }
+            sent_ns[i] = now;
+            forwarded_ns[i] = steady_now_ns();
+            data.stamp(i, now);
+            while (!out.try_push(data)) {
+                std::this_thread::yield();
+            }
+        }
+        while (!out.flushed()) {
+            out.flush();
+            std::this_thread::yield();
+        }
+    });
+    
+    for (size_t s = 0; s < stages; ++s) {
+        threads.emplace_back([&, s]() {
+            Data data;
+            Q& in = *channels[s];
+            Q* out = s + 1 < stages ? channels[s + 1].get() : nullptr;
+            const double work = config.work_ns[s % config.work_ns.size()];
+            size_t received = 0;
+            
+            while (received < n) {
+                if (!in.try_pop(data)) {
+                    if (out) out->flush();
+                    std::this_thread::yield();
+                    continue;
+                }
+                const uint64_t begin = steady_now_ns();
+                hop_latencies[s].push_back(static_cast<double>(begin - forwarded_ns[data.id]));
+                ++received;
+                
+                spin_for_ns(work);
+                // 忙碌时间只算本级的处理：不含等待上游，也不含向下游发送时被背压阻塞的时间，
+                // 否则瓶颈之前的各级都会因为推不动而显得和瓶颈一样慢
+                const uint64_t done = steady_now_ns();
+                busy_ns[s] += static_cast<double>(done - begin);
+                
+                if (out) {
+                    forwarded_ns[data.id] = done;
+                    while (!out->try_push(data)) {
+                        std::this_thread::yield();
+                    }
+                } else {
+                    e2e_latencies.push_back(static_cast<double>(done - sent_ns[data.id]));
+                    last_receive_ns = done;
+                }
+            }
+            while (out && !out->flushed()) {
+                out->flush();
+                std::this_thread::yield();
+            }
+        });
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    PipelineResult result;
+    result.name = queue_display_name(queue_type);
+    result.queue_type = queue_type;
+    result.stages = stages;
+    result.capacity = capacity;
+    result.payload_bytes = sizeof(Data);
+    result.throughput = n / ((last_receive_ns - start_ns) / 1e9);
+    
+    std::sort(e2e_latencies.begin(), e2e_latencies.end());
+    double sum = 0.0;
+    for (double latency : e2e_latencies) sum += latency;
+    result.e2e_mean_ns = sum / n;
+    result.e2e_p50_ns = percentile(e2e_latencies, 0.50);
+    result.e2e_p99_ns = percentile(e2e_latencies, 0.99);
+    result.e2e_p999_ns = percentile(e2e_latencies, 0.999);
+    
+    for (size_t s = 0; s < stages; ++s) {
+        double hop_sum = 0.0;
+        for (double latency : hop_latencies[s]) hop_sum += latency;
+        result.hop_mean_ns.push_back(hop_sum / n);
+        result.stage_capacity.push_back(busy_ns[s] > 0.0 ? n / (busy_ns[s] / 1e9) : 0.0);
+    }
+    auto slowest = std::min_element(result.stage_capacity.begin(), result.stage_capacity.end());
+    result.bottleneck_stage = static_cast<size_t>(slowest - result.stage_capacity.begin()) + 1;
+    return result;
+}
+
+void print_pipeline_results(const std::vector<PipelineResult>& results) {
+    std::cout << "\n" << std::string(146, '=') << std::endl;
+    std::cout << "流水线测试结果（K级 = K个队列跳）" << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << std::left << std::setw(22) << "队列类型"
+              << std::setw(8) << "级数"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "消息(B)"
+              << std::setw(15) << "吞吐量(ops/s)"
+              << std::setw(14) << "端到端均值"
+              << std::setw(14) << "端到端P50"
+              << std::setw(14) << "端到端P99"
+              << std::setw(14) << "端到端P99.9"
+              << std::setw(12) << "瓶颈级"
+              << "瓶颈能力(ops/s)" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::setw(22) << r.name
+                  << std::setw(8) << r.stages
+                  << std::setw(10) << r.capacity
+                  << std::setw(10) << r.payload_bytes
+                  << std::setw(15) << std::fixed << std::setprecision(0) << r.throughput
+                  << std::setw(14) << std::setprecision(1) << r.e2e_mean_ns
+                  << std::setw(14) << r.e2e_p50_ns
+                  << std::setw(14) << r.e2e_p99_ns
+                  << std::setw(14) << r.e2e_p999_ns
+                  << std::setw(12) << r.bottleneck_stage
+                  << std::setprecision(0) << r.stage_capacity[r.bottleneck_stage - 1] << std::endl;
+        
+        std::cout << "    每跳平均延迟(ns):";
+        for (double hop : r.hop_mean_ns) {
+            std::cout << ' ' << std::setprecision(1) << hop;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::string(146, '=') << std::endl;
+}
+
+void write_number_array(std::ostream& out, const std::vector<double>& values) {
+    out << "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << (i ? ", " : "") << values[i];
+    }
+    out << "]";
+}
+
+bool write_pipeline_json(const std::string& path, const std::vector<PipelineResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(1);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << json_escape(r.name) << "\""
+            << ", \"queue\": \"" << json_escape(r.queue_type) << "\""
+            << ", \"stages\": " << r.stages
+            << ", \"capacity\": " << r.capacity
+            << ", \"payload_bytes\": " << r.payload_bytes
+            << ", \"throughput_ops\": " << r.throughput
+            << ", \"e2e_mean_ns\": " << r.e2e_mean_ns
+            << ", \"e2e_p50_ns\": " << r.e2e_p50_ns
+            << ", \"e2e_p99_ns\": " << r.e2e_p99_ns
+            << ", \"e2e_p999_ns\": " << r.e2e_p999_ns
+            << ", \"bottleneck_stage\": " << r.bottleneck_stage
+            << ", \"hop_mean_ns\": ";
+        write_number_array(out, r.hop_mean_ns);
+        out << ", \"stage_capacity_ops\": ";
+        write_number_array(out, r.stage_capacity);
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    return static_cast<bool>(out);
+}
+
+bool write_pipeline_csv(const std::string& path, const std::vector<PipelineResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    // 每跳指标按行展开，便于绘制延迟随级数累积的曲线
+    out << std::fixed << std::setprecision(1);
+    out << "name,queue,stages,capacity,payload_bytes,throughput_ops,e2e_mean_ns,e2e_p50_ns,"
+           "e2e_p99_ns,e2e_p999_ns,bottleneck_stage,hop,hop_mean_ns,stage_capacity_ops\n";
+    for (const auto& r : results) {
+        for (size_t s = 0; s < r.stages; ++s) {
+            out << r.name << ',' << r.queue_type << ',' << r.stages << ',' << r.capacity << ','
+                << r.payload_bytes << ',' << r.throughput << ',' << r.e2e_mean_ns << ','
+                << r.e2e_p50_ns << ',' << r.e2e_p99_ns << ',' << r.e2e_p999_ns << ','
+                << r.bottleneck_stage << ',' << s + 1 << ',' << r.hop_mean_ns[s] << ','
+                << r.stage_capacity[s] << '\n';
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+// 消费者停顿测试配置：生产者按恒定速率发送、队列满则丢弃，
+// 消费者周期性停顿（模拟GC、缺页、日志刷盘）并可附加逐条处理开销
+struct StallConfig {
+    double rate = 1000000.0;           // 生产者发送速率(ops/s)
+    double stall_us = 1000.0;          // 每次停顿时长
+    double stall_period_us = 20000.0;  // 停顿周期，0表示不停顿
+    double consumer_work_ns = 0.0;     // 消费者逐条处理耗时
+    size_t num_operations = 1000000;
+    size_t batch_size = 0;
+};
+
+struct StallResult {
+    std::string name;
+    std::string queue_type;
+    size_t capacity = 0;
+    size_t payload_bytes = 0;
+    size_t offered = 0;
+    size_t rejected = 0;               // 队列满被拒绝的消息数
+    size_t max_depth = 0;              // 生产者每次发送后观测到的最大队列深度
+    size_t stalls = 0;
+    double mean_recovery_us = 0.0;     // 停顿结束到收到第一条停顿后才发送的消息的平均时间
+    double max_recovery_us = 0.0;
+    double p99_latency_ns = 0.0;       // 已送达消息从预定发送时刻算起的延迟
+    double max_latency_ns = 0.0;
+};
+
+template<typename Q, typename Data>
+StallResult run_stall(const StallConfig& config, const std::string& queue_type, size_t capacity) {
+    auto channel = std::make_unique<Q>(capacity, config.batch_size);
+    const size_t n = config.num_operations;
+    const double interval_ns = 1e9 / config.rate;
+    
+    std::atomic<bool> producer_done{false};
+    size_t rejected = 0;
+    size_t max_depth = 0;
+    size_t stalls = 0;
+    std::vector<double> recoveries_us;
+    std::vector<double> latencies;
+    latencies.reserve(n);
+    
+    const uint64_t start_ns = steady_now_ns() + 1000000;
+    
+    std::thread producer([&]() {
+        Data data;
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t intended = start_ns + static_cast<uint64_t>(i * interval_ns);
+            while (steady_now_ns() < intended) {
+                channel->flush();
+                std::this_thread::yield();
+            }
+            
+            data.stamp(i, intended);
+            if (!channel->try_push(data)) {
+                ++rejected;
+            }
+            max_depth = std::max(max_depth, channel->size());
+        }
+        while (!channel->flushed()) {
+            channel->flush();
+            std::this_thread::yield();
+        }
+        producer_done.store(true, std::memory_order_release);
+    });
+    
+    std::thread consumer([&]() {
+        Data data;
+        const bool stalling = config.stall_period_us > 0.0 && config.stall_us > 0.0;
+        uint64_t next_stall_ns = start_ns + static_cast<uint64_t>(config.stall_period_us * 1000.0);
+        uint64_t stall_end_ns = 0;     // 非0表示正在等待从上次停顿中恢复
+        
+        while (true) {
+            if (stalling && steady_now_ns() >= next_stall_ns) {
+                // 停顿期间让出CPU，生产者继续按速率发送
+                std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(config.stall_us)));
+                stall_end_ns = steady_now_ns();
+                next_stall_ns = stall_end_ns + static_cast<uint64_t>(config.stall_period_us * 1000.0);
+                ++stalls;
+            }
+            
+            // 先读完成标志再出队：标志为真时出队失败说明队列确实已空，出队成功的消息照常处理
+            const bool done = producer_done.load(std::memory_order_acquire);
+            if (channel->try_pop(data)) {
+                spin_for_ns(config.consumer_work_ns);
+                const uint64_t now = steady_now_ns();
+                const uint64_t intended = start_ns + static_cast<uint64_t>(data.id * interval_ns);
+                latencies.push_back(static_cast<double>(now - intended));
+                
+                // 收到停顿结束后才发送的消息，说明停顿期间的积压已消化完
+                if (stall_end_ns != 0 && intended >= stall_end_ns) {
+                    recoveries_us.push_back((now - stall_end_ns) / 1000.0);
+                    stall_end_ns = 0;
+                }
+                continue;
+            }
+            
+            if (done) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    });
+    
+    producer.join();
+    consumer.join();
+    
+    StallResult result;
+    result.name = queue_display_name(queue_type);
+    result.queue_type = queue_type;
+    result.capacity = capacity;
+    result.payload_bytes = sizeof(Data);
+    result.offered = n;
+    result.rejected = rejected;
+    result.max_depth = max_depth;
+    result.stalls = stalls;
+    if (!recoveries_us.empty()) {
+        double sum = 0.0;
+        for (double r : recoveries_us) sum += r;
+        result.mean_recovery_us = sum / recoveries_us.size();
+        result.max_recovery_us = *std::max_element(recoveries_us.begin(), recoveries_us.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.p99_latency_ns = percentile(latencies, 0.99);
+    result.max_latency_ns = latencies.empty() ? 0.0 : latencies.back();
+    return result;
+}
+
+void print_stall_results(const StallConfig& config, const std::vector<StallResult>& results) {
+    std::cout << "\n" << std::string(146, '=') << std::endl;
+    std::cout << "消费者停顿测试结果（速率 " << std::fixed << std::setprecision(0) << config.rate
+              << " ops/s，每 " << config.stall_period_us << "us 停顿 " << config.stall_us
+              << "us，逐条处理 " << config.consumer_work_ns << "ns）" << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << std::left << std::setw(22) << "队列类型"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "消息(B)"
+              << std::setw(12) << "发送数"
+              << std::setw(12) << "拒绝率"
+              << std::setw(12) << "最大深度"
+              << std::setw(10) << "停顿次数"
+              << std::setw(16) << "平均恢复(us)"
+              << std::setw(16) << "最大恢复(us)"
+              << std::setw(14) << "P99延迟(ns)"
+              << "最大延迟(ns)" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    
+    for (const auto& r : results) {
+        std::ostringstream reject_text;
+        reject_text << std::fixed << std::setprecision(3) << (100.0 * r.rejected / r.offered) << "%";
+        
+        std::cout << std::setw(22) << r.name
+                  << std::setw(10) << r.capacity
+                  << std::setw(10) << r.payload_bytes
+                  << std::setw(12) << r.offered
+                  << std::setw(12) << reject_text.str()
+                  << std::setw(12) << r.max_depth
+                  << std::setw(10) << r.stalls
+                  << std::setw(16) << std::setprecision(1) << r.mean_recovery_us
+                  << std::setw(16) << r.max_recovery_us
+                  << std::setw(14) << r.p99_latency_ns
+                  << r.max_latency_ns << std::endl;
+    }
+    std::cout << std::string(146, '=') << std::endl;
+}
+
+bool write_stall_json(const std::string& path, const StallConfig& config, const std::vector<StallResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(1);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << json_escape(r.name) << "\""
+            << ", \"queue\": \"" << json_escape(r.queue_type) << "\""
+            << ", \"capacity\": " << r.capacity
+            << ", \"payload_bytes\": " << r.payload_bytes
+            << ", \"rate_ops\": " << config.rate
+            << ", \"stall_us\": " << config.stall_us
+            << ", \"stall_period_us\": " << config.stall_period_us
+            << ", \"consumer_work_ns\": " << config.consumer_work_ns
+            << ", \"offered\": " << r.offered
+            << ", \"rejected\": " << r.rejected
+            << ", \"max_depth\": " << r.max_depth
+            << ", \"stalls\": " << r.stalls
+            << ", \"mean_recovery_us\": " << r.mean_recovery_us
+            << ", \"max_recovery_us\": " << r.max_recovery_us
+            << ", \"p99_ns\": " << r.p99_latency_ns
+            << ", \"max_ns\": " << r.max_latency_ns
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    return static_cast<bool>(out);
+}
+
+bool write_stall_csv(const std::string& path, const StallConfig& config, const std::vector<StallResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(1);
+    out << "name,queue,capacity,payload_bytes,rate_ops,stall_us,stall_period_us,consumer_work_ns,"
+           "offered,rejected,max_depth,stalls,mean_recovery_us,max_recovery_us,p99_ns,max_ns\n";
+    for (const auto& r : results) {
+        out << r.name << ',' << r.queue_type << ',' << r.capacity << ',' << r.payload_bytes << ','
+            << config.rate << ',' << config.stall_us << ',' << config.stall_period_us << ','
+            << config.consumer_work_ns << ',' << r.offered << ',' << r.rejected << ','
+            << r.max_depth << ',' << r.stalls << ',' << r.mean_recovery_us << ','
+            << r.max_recovery_us << ',' << r.p99_latency_ns << ',' << r.max_latency_ns << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// 事件循环通知测试配置：生产者按恒定速率发送，消费者读空队列后要么忙等（spin），
+// 要么登记后在epoll_wait上休眠、由eventfd唤醒（eventfd），对比唤醒延迟、系统调用次数和CPU占用
+struct NotifyConfig {
+    std::vector<double> rates{1000.0, 10000.0, 100000.0};
+    double duration_s = 1.0;           // 每个速率的发送时长，消息数为速率×时长
+    size_t drain_batch = 64;           // 消费者每次批量出队的上限
+};
+
+struct NotifyResult {
+    std::string waiter;                // spin, eventfd
+    size_t capacity = 0;
+    size_t payload_bytes = 0;
+    double rate = 0.0;
+    size_t messages = 0;
+    double p50_ns = 0.0;               // 从预定发送时刻到消费者取出
+    double p99_ns = 0.0;
+    double max_ns = 0.0;
+    double signals_per_msg = 0.0;      // 生产者写eventfd的次数/条
+    double waits_per_msg = 0.0;        // 消费者epoll_wait的次数/条
+    size_t lost_wakeups = 0;           // epoll_wait超时返回时队列非空的次数，非0说明登记/通知丢失了唤醒
+    double consumer_cpu = 0.0;         // 消费者线程CPU时间/墙钟时间
+    std::string error;                 // 非空表示未能运行
+};
+
+// 调用线程已消耗的CPU时间
+uint64_t thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+template<typename Data, size_t Capacity>
+NotifyResult run_notify(const NotifyConfig& config, double rate, const std::string& waiter) {
+    auto queue = std::make_unique<EventfdSPSCQueue<Data, Capacity>>();
+    const bool use_eventfd = waiter == "eventfd";
+    const size_t n = std::max<size_t>(1, static_cast<size_t>(rate * config.duration_s));
+    const double interval_ns = 1e9 / rate;
+    
+    NotifyResult result;
+    result.waiter = waiter;
+    result.capacity = Capacity;
+    result.payload_bytes = sizeof(Data);
+    result.rate = rate;
+    result.messages = n;
+
+#ifdef __linux__
+    int epoll_fd = -1;
+    if (use_eventfd) {
+        epoll_fd = queue->notifier().available() ? epoll_create1(EPOLL_CLOEXEC) : -1;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = queue->fd();
+        if (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, queue->fd(), &event) != 0) {
+            result.error = queue->notifier().available() ? std::string("epoll失败: ") + strerror(errno)
+                                                         : queue->notifier().error();
+            if (epoll_fd >= 0) close(epoll_fd);
+            return result;
+        }
+    }
+#else
+    if (use_eventfd) {
+        result.error = queue->notifier().error();
+        return result;
+    }
+#endif
+    
+    std::vector<double> latencies;
+    latencies.reserve(n);
+    size_t waits = 0;
+    size_t lost_wakeups = 0;
+    uint64_t consumer_cpu_ns = 0;
+    uint64_t end_ns = 0;
+    const uint64_t start_ns = steady_now_ns() + 1000000;
+    
+    // 两次发送之间较长时休眠，生产者不占满CPU，消费者的CPU占用才有可比性
+    std::thread producer([&]() {
+        Data data;
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t intended = start_ns + static_cast<uint64_t>(i * interval_ns);
+            uint64_t now = steady_now_ns();
+            if (intended > now + 200000) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(intended - now - 100000));
+            }
+            while (steady_now_ns() < intended) {
+                std::this_thread::yield();
+            }
+            
+            data.stamp(i, intended);
+            while (!queue->enqueue(data)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    std::thread consumer([&]() {
+        std::vector<Data> batch(config.drain_batch);
+        const uint64_t cpu_start = thread_cpu_ns();
+        size_t received = 0;
+        
+        while (received < n) {
+            const size_t got = queue->dequeue_bulk(batch.data(), batch.size());
+            if (got > 0) {
+                const uint64_t now = steady_now_ns();
+                for (size_t i = 0; i < got; ++i) {
+                    const uint64_t intended = start_ns + static_cast<uint64_t>(batch[i].id * interval_ns);
+                    latencies.push_back(static_cast<double>(now - intended));
+                }
+                received += got;
+                continue;
+            }
+            
+            if (!use_eventfd) {
+                SpinWait::pause();
+                continue;
+            }
+#ifdef __linux__
+            if (!queue->arm()) {
+                continue;  // 登记期间有新数据
+            }
+            epoll_event ready;
+            ++waits;
+            const int ready_count = epoll_wait(epoll_fd, &ready, 1, 100);
+            if (ready_count > 0) {
+                queue->acknowledge();
+            } else if (ready_count == 0 && queue->size() > 0) {
+                ++lost_wakeups;  // 已登记且队列非空却没有收到通知，只能靠超时兜底
+            }
+#endif
+        }
+        
+        consumer_cpu_ns = thread_cpu_ns() - cpu_start;
+        end_ns = steady_now_ns();
+    });
+    
+    producer.join();
+    consumer.join();
+#ifdef __linux__
+    if (epoll_fd >= 0) close(epoll_fd);
+#endif
+    
+    std::sort(latencies.begin(), latencies.end());
+    result.p50_ns = percentile(latencies, 0.5);
+    result.p99_ns = percentile(latencies, 0.99);
+    result.max_ns = latencies.empty() ? 0.0 : latencies.back();
+    result.signals_per_msg = static_cast<double>(queue->notifier().signals()) / n;
+    result.waits_per_msg = static_cast<double>(waits) / n;
+    result.lost_wakeups = lost_wakeups;
+    result.consumer_cpu = end_ns > start_ns ? static_cast<double>(consumer_cpu_ns) / (end_ns - start_ns) : 0.0;
+    return result;
+}
+
+void print_notify_results(const std::vector<NotifyResult>& results) {
+    std::cout << "\n" << std::string(146, '=') << std::endl;
+    std::cout << "事件循环通知测试结果（spin: 忙等消费者；eventfd: 读空后登记并在epoll_wait上休眠）" << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << std::left << std::setw(16) << "等待方式"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "消息(B)"
+              << std::setw(14) << "速率(ops/s)"
+              << std::setw(12) << "消息数"
+              << std::setw(14) << "P50延迟(ns)"
+              << std::setw(14) << "P99延迟(ns)"
+              << std::setw(16) << "最大延迟(ns)"
+              << std::setw(18) << "eventfd写/条"
+              << std::setw(18) << "epoll_wait/条"
+              << "消费者CPU" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::setw(16) << r.waiter
+                  << std::setw(10) << r.capacity
+                  << std::setw(10) << r.payload_bytes
+                  << std::setw(14) << std::fixed << std::setprecision(0) << r.rate;
+        if (!r.error.empty()) {
+            std::cout << "不可用: " << r.error << std::endl;
+            continue;
+        }
+        std::ostringstream cpu_text;
+        cpu_text << std::fixed << std::setprecision(1) << 100.0 * r.consumer_cpu << "%";
+        std::cout << std::setw(12) << r.messages
+                  << std::setw(14) << std::setprecision(1) << r.p50_ns
+                  << std::setw(14) << r.p99_ns
+                  << std::setw(16) << r.max_ns
+                  << std::setw(18) << std::setprecision(3) << r.signals_per_msg
+                  << std::setw(18) << r.waits_per_msg
+                  << cpu_text.str() << std::endl;
+    }
+    std::cout << std::string(146, '=') << std::endl;
+}
+
+bool write_notify_json(const std::string& path, const NotifyConfig& config, const std::vector<NotifyResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(3);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"waiter\": \"" << json_escape(r.waiter) << "\""
+            << ", \"capacity\": " << r.capacity
+            << ", \"payload_bytes\": " << r.payload_bytes
+            << ", \"rate_ops\": " << r.rate
+            << ", \"drain_batch\": " << config.drain_batch
+            << ", \"messages\": " << r.messages
+            << ", \"p50_ns\": " << r.p50_ns
+            << ", \"p99_ns\": " << r.p99_ns
+            << ", \"max_ns\": " << r.max_ns
+            << ", \"signals_per_msg\": " << r.signals_per_msg
+            << ", \"waits_per_msg\": " << r.waits_per_msg
+            << ", \"lost_wakeups\": " << r.lost_wakeups
+            << ", \"consumer_cpu\": " << r.consumer_cpu
+            << ", \"error\": \"" << json_escape(r.error) << "\""
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    return static_cast<bool>(out);
+}
+
+bool write_notify_csv(const std::string& path, const NotifyConfig& config, const std::vector<NotifyResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(3);
+    out << "waiter,capacity,payload_bytes,rate_ops,drain_batch,messages,p50_ns,p99_ns,max_ns,"
+           "signals_per_msg,waits_per_msg,lost_wakeups,consumer_cpu\n";
+    for (const auto& r : results) {
+        if (!r.error.empty()) continue;
+        out << r.waiter << ',' << r.capacity << ',' << r.payload_bytes << ',' << r.rate << ','
+            << config.drain_batch << ',' << r.messages << ',' << r.p50_ns << ',' << r.p99_ns << ','
+            << r.max_ns << ',' << r.signals_per_msg << ',' << r.waits_per_msg << ','
+            << r.lost_wakeups << ',' << r.consumer_cpu << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// 命令行选项，列表型参数用逗号分隔，所有列表做笛卡尔积扫描
+struct CommandLineOptions {
+    std::string mode = "throughput";  // throughput, openloop, pipeline, stall, footprint, notify
+    std::vector<size_t> capacities{1024};
+    std::vector<size_t> operations{1000000};
+    std::vector<size_t> payloads{64};
+    std::vector<size_t> batch_sizes{0};
+    std::vector<std::string> queue_types{"spsc", "locked", "double_buffer"};
+    size_t warmup_operations = 10000;
+    size_t pop_bulk = 1;
+    size_t producers = 1;
+    size_t consumers = 1;
+    int num_runs = 3;
+    bool collect_perf = true;
+    uint64_t perf_hitm_event = 0;
+    std::string json_path;
+    std::string csv_path;
+    std::string baseline_path;        // 非空时按基线文件中的用例矩阵重跑并对比
+    double regression_threshold = 0.05;
+    double significance = 0.05;
+    OpenLoopConfig open_loop;
+    PipelineConfig pipeline;
+    StallConfig stall;
+    NotifyConfig notify;
+};
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --mode=M             测试模式: throughput（默认）, openloop, pipeline, stall, footprint, notify\n"
+              << "  --capacity=N[,N...]  队列容量（可选: " << size_list_string(SupportedCapacities{}) << "）\n"
+              << "  --ops=N[,N...]       每轮操作次数\n"
+              << "  --payload=N[,N...]   消息字节数（可选: " << size_list_string(SupportedPayloads{}) << "）\n"
+              << "  --batch=N[,N...]     双缓冲切换批大小，0表示容量/4\n"
+              << "  --queue=T[,T...]     队列类型: spsc, spsc_stats, locked, double_buffer, mpsc, mpmc\n"
+              << "  --warmup=N           预热操作次数\n"
+              << "  --pop-bulk=N         消费者每次最多出队N个（批量接口，默认1）\n"
+              << "  --producers=N        mpsc/mpmc/locked的生产者线程数（默认1）\n"
+              << "  --consumers=N        mpmc/locked的消费者线程数（默认1）\n"
+              << "  --runs=N             每个用例运行次数\n"
+              << "  --no-perf            不采集硬件性能计数器\n"
+              << "  --perf-hitm=HEX      HITM原始事件编码（与CPU型号相关，如0x04d2）\n"
+              << "  --json=PATH          以JSON格式写出结果\n"
+              << "  --csv=PATH           以CSV格式写出结果\n"
+              << "  --baseline=PATH      按基线JSON中的用例重跑并对比，显著回退时返回2\n"
+              << "  --threshold=PCT      判定回退的最小下降百分比（默认5）\n"
+              << "  --alpha=P            显著性水平（默认0.05）\n"
+              << "开环模式（--mode=openloop）:\n"
+              << "  --arrival=A          到达模型: constant, poisson, bursty\n"
+              << "  --rates=R[,R...]     绝对发送速率(ops/s)，指定后不再测量饱和吞吐量\n"
+              << "  --loads=F[,F...]     相对饱和吞吐量的负载比例（默认0.1,0.3,0.5,0.7,0.9,1.0,1.2）\n"
+              << "  --duty=F             bursty模式下发送时间占比（默认0.2）\n"
+              << "  --period-us=N        bursty模式下开关周期（默认1000）\n"
+              << "流水线模式（--mode=pipeline）:\n"
+              << "  --stages=K[,K...]    级数（队列跳数），默认1,2,4\n"
+              << "  --work-ns=N[,N...]   各级合成计算耗时，按级循环取值（默认0）\n"
+              << "  --rates=R            源端恒定发送速率，省略时尽力发送\n"
+              << "消费者停顿模式（--mode=stall）:\n"
+              << "  --rates=R            生产者恒定发送速率（默认1000000），队列满时丢弃\n"
+              << "  --stall-us=N         每次停顿时长（默认1000）\n"
+              << "  --stall-period-us=N  停顿周期，0表示不停顿（默认20000）\n"
+              << "  --consumer-work-ns=N 消费者逐条处理耗时（默认0）\n"
+              << "事件循环通知模式（--mode=notify，只测试SPSC无锁队列，忽略--queue）:\n"
+              << "  --rates=R[,R...]     生产者恒定发送速率（默认1000,10000,100000）\n"
+              << "  --duration-s=F       每个速率的发送时长（默认1）\n"
+              << "  --drain=N            消费者每次批量出队的上限（默认64）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+std::vector<size_t> parse_size_list(const std::string& value) {
+    std::vector<size_t> sizes;
+    for (const auto& item : split_list(value)) {
+        sizes.push_back(std::stoull(item));
+    }
+    return sizes;
+}
+
+std::vector<double> parse_double_list(const std::string& value) {
+    std::vector<double> values;
+    for (const auto& item : split_list(value)) {
+        values.push_back(std::stod(item));
+    }
+    return values;
+}
+
+// 解析失败时打印原因并返回false
+bool parse_command_line(int argc, char* argv[], CommandLineOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string key = arg;
+        std::string value;
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            key = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+        }
+        
+        try {
+            if (key == "--help" || key == "-h") {
+                print_usage(argv[0]);
+                std::exit(0);
+            } else if (key == "--mode") {
+                options.mode = value;
+            } else if (key == "--arrival") {
+                options.open_loop.arrival = value;
+            } else if (key == "--rates") {
+                options.open_loop.rates = parse_double_list(value);
+            } else if (key == "--loads") {
+                options.open_loop.loads = parse_double_list(value);
+            } else if (key == "--duty") {
+                options.open_loop.duty = std::stod(value);
+            } else if (key == "--period-us") {
+                options.open_loop.period_us = std::stod(value);
+            } else if (key == "--stages") {
+                options.pipeline.stage_counts = parse_size_list(value);
+            } else if (key == "--work-ns") {
+                options.pipeline.work_ns = parse_double_list(value);
+            } else if (key == "--stall-us") {
+                options.stall.stall_us = std::stod(value);
+            } else if (key == "--stall-period-us") {
+                options.stall.stall_period_us = std::stod(value);
+            } else if (key == "--consumer-work-ns") {
+                options.stall.consumer_work_ns = std::stod(value);
+            } else if (key == "--duration-s") {
+                options.notify.duration_s = std::stod(value);
+            } else if (key == "--drain") {
+                options.notify.drain_batch = std::stoull(value);
+            } else if (key == "--capacity") {
+                options.capacities = parse_size_list(value);
+            } else if (key == "--ops") {
+                options.operations = parse_size_list(value);
+            } else if (key == "--payload") {
+                options.payloads = parse_size_list(value);
+            } else if (key == "--batch") {
+                options.batch_sizes = parse_size_list(value);
+            } else if (key == "--queue") {
+                options.queue_types = split_list(value);
+            } else if (key == "--warmup") {
+                options.warmup_operations = std::stoull(value);
+            } else if (key == "--pop-bulk") {
+                options.pop_bulk = std::stoull(value);
+            } else if (key == "--producers") {
+                options.producers = std::stoull(value);
+            } else if (key == "--consumers") {
+                options.consumers = std::stoull(value);
+            } else if (key == "--runs") {
+                options.num_runs = std::stoi(value);
+            } else if (key == "--no-perf") {
+                options.collect_perf = false;
+            } else if (key == "--perf-hitm") {
+                options.perf_hitm_event = std::stoull(value, nullptr, 16);
+            } else if (key == "--json") {
+                options.json_path = value;
+            } else if (key == "--csv") {
+                options.csv_path = value;
+            } else if (key == "--baseline") {
+                options.baseline_path = value;
+            } else if (key == "--threshold") {
+                options.regression_threshold = std::stod(value) / 100.0;
+            } else if (key == "--alpha") {
+                options.significance = std::stod(value);
+            } else {
+                std::cerr << "未知参数: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数格式错误: " << arg << std::endl;
+            return false;
+        }
+    }
+    
+    for (size_t capacity : options.capacities) {
+        if (!dispatch_size(capacity, SupportedCapacities{}, [](auto) {})) {
+            std::cerr << "不支持的容量: " << capacity
+                      << "（可选: " << size_list_string(SupportedCapacities{}) << "）" << std::endl;
+            return false;
+        }
+    }
+    for (size_t payload : options.payloads) {
+        if (!dispatch_size(payload, SupportedPayloads{}, [](auto) {})) {
+            std::cerr << "不支持的消息大小: " << payload
+                      << "（可选: " << size_list_string(SupportedPayloads{}) << "）" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& type : options.queue_types) {
+        if (!is_known_queue_type(type)) {
+            std::cerr << "未知队列类型: " << type << std::endl;
+            return false;
+        }
+    }
+    for (size_t batch : options.batch_sizes) {
+        for (size_t capacity : options.capacities) {
+            if (batch > capacity) {
+                std::cerr << "批大小 " << batch << " 超过容量 " << capacity << std::endl;
+                return false;
+            }
+        }
+    }
+    if (options.mode != "throughput" && options.mode != "openloop" && options.mode != "pipeline" &&
+        options.mode != "stall" && options.mode != "footprint" && options.mode != "notify") {
+        std::cerr << "未知测试模式: " << options.mode << std::endl;
+        return false;
+    }
+    const auto& arrival = options.open_loop.arrival;
+    if (arrival != "constant" && arrival != "poisson" && arrival != "bursty") {
+        std::cerr << "未知到达模型: " << arrival << std::endl;
+        return false;
+    }
+    if (options.open_loop.duty <= 0.0 || options.open_loop.duty > 1.0 || options.open_loop.period_us <= 0.0) {
+        std::cerr << "duty必须在(0, 1]之间，period-us必须为正" << std::endl;
+        return false;
+    }
+    if (options.notify.duration_s <= 0.0 || options.notify.drain_batch == 0 ||
+        (options.mode == "notify" && std::any_of(options.open_loop.rates.begin(), options.open_loop.rates.end(),
+                                                 [](double rate) { return rate <= 0.0; }))) {
+        std::cerr << "duration-s、drain和通知模式的速率必须为正" << std::endl;
+        return false;
+    }
+    if (options.pipeline.stage_counts.empty() || options.pipeline.work_ns.empty() ||
+        std::find(options.pipeline.stage_counts.begin(), options.pipeline.stage_counts.end(), 0) !=
+            options.pipeline.stage_counts.end()) {
+        std::cerr << "级数必须为正，work-ns不能为空" << std::endl;
+        return false;
+    }
+    if (options.regression_threshold < 0.0 || options.significance <= 0.0 || options.significance >= 1.0) {
+        std::cerr << "threshold不能为负，alpha必须在(0, 1)之间" << std::endl;
+        return false;
+    }
+    if (options.num_runs <= 0 || options.pop_bulk == 0 || options.producers == 0 || options.consumers == 0 ||
+        options.operations.empty() || options.capacities.empty() || options.payloads.empty() ||
+        options.batch_sizes.empty() || options.queue_types.empty()) {
+        std::cerr << "参数列表不能为空，运行次数、批量出队数和线程数必须为正" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 运行单个队列类型的单个配置
+template<typename Data>
+BenchmarkResult run_case_with_payload(const std::string& queue_type, const BenchmarkConfig& config) {
+    BenchmarkResult result;
+    dispatch_queue<Data>(queue_type, config.queue_size, [&](auto tag) {
+        result = benchmark_queue<typename decltype(tag)::type, Data>(config, queue_type);
+    });
+    return result;
+}
+
+BenchmarkResult run_case(const std::string& queue_type, const BenchmarkConfig& config) {
+    BenchmarkResult result;
+    dispatch_size(config.payload_bytes, SupportedPayloads{}, [&](auto bytes) {
+        result = run_case_with_payload<Payload<decltype(bytes)::value>>(queue_type, config);
+    });
+    return result;
+}
+
+// 待运行的单个用例
+struct BenchmarkCase {
+    std::string queue_type;
+    BenchmarkConfig config;
+};
+
+// 由命令行列表的笛卡尔积生成用例
+std::vector<BenchmarkCase> build_cases(const CommandLineOptions& options) {
+    std::vector<BenchmarkCase> cases;
+    for (size_t ops : options.operations) {
+        for (size_t payload : options.payloads) {
+            for (size_t capacity : options.capacities) {
+                for (const auto& queue_type : options.queue_types) {
+                    // 批大小只影响双缓冲，其余队列每个容量只跑一次
+                    std::vector<size_t> batches;
+                    if (queue_type == "double_buffer") {
+                        for (size_t batch : options.batch_sizes) {
+                            size_t effective = batch ? batch : capacity / 4;
+                            if (std::find(batches.begin(), batches.end(), effective) == batches.end()) {
+                                batches.push_back(effective);
+                            }
+                        }
+                    } else {
+                        batches.assign(1, 0);
+                    }
+                    
+                    for (size_t batch : batches) {
+                        BenchmarkCase c;
+                        c.queue_type = queue_type;
+                        c.config.num_operations = ops;
+                        c.config.queue_size = capacity;
+                        c.config.warmup_operations = options.warmup_operations;
+                        c.config.num_runs = options.num_runs;
+                        c.config.batch_size = batch;
+                        c.config.payload_bytes = payload;
+                        c.config.producers = options.producers;
+                        c.config.consumers = options.consumers;
+                        cases.push_back(c);
+                    }
+                }
+            }
+        }
+    }
+    return cases;
+}
+
+// 按基线文件中的用例重建矩阵，参数与基线保持一致
+bool cases_from_baseline(const std::vector<BenchmarkResult>& baseline, std::vector<BenchmarkCase>& cases) {
+    for (const auto& base : baseline) {
+        if (!is_known_queue_type(base.queue_type) ||
+            !dispatch_size(base.capacity, SupportedCapacities{}, [](auto) {}) ||
+            !dispatch_size(base.payload_bytes, SupportedPayloads{}, [](auto) {}) ||
+            base.num_runs <= 0) {
+            std::cerr << "基线中的用例无法在当前版本复现: " << base.queue_type
+                      << " 容量 " << base.capacity << " 消息 " << base.payload_bytes << "B" << std::endl;
+            return false;
+        }
+        const std::string wait = queue_wait_policy(base.queue_type, base.capacity);
+        if (base.wait_policy != wait) {
+            std::cerr << "基线中 " << base.queue_type << " 的等待策略（"
+                      << (base.wait_policy.empty() ? "未记录" : base.wait_policy) << "）与当前（" << wait
+                      << "）不同，结果不可比较，请用当前版本重新录制基线" << std::endl;
+            return false;
+        }
+        
+        BenchmarkCase c;
+        c.queue_type = base.queue_type;
+        c.config.num_operations = base.num_operations;
+        c.config.queue_size = base.capacity;
+        c.config.warmup_operations = base.warmup_operations;
+        c.config.num_runs = base.num_runs;
+        c.config.batch_size = base.batch_size;
+        c.config.payload_bytes = base.payload_bytes;
+        c.config.producers = base.producers;
+        c.config.consumers = base.consumers;
+        cases.push_back(c);
+    }
+    return true;
+}
+
+// 内存占用统计：用于按L2/L3预算规划大量按连接分配的队列
+constexpr size_t kCacheLineBytes = 64;
+
+struct FootprintResult {
+    std::string name;
+    std::string queue_type;
+    size_t capacity = 0;
+    size_t payload_bytes = 0;
+    size_t object_bytes = 0;           // sizeof(队列)，即内联部分
+    size_t resident_empty_bytes = 0;   // 构造后堆上驻留字节（含对象本身和分配器开销）
+    size_t resident_full_bytes = 0;    // 写满后堆上驻留字节
+    size_t max_in_flight = 0;          // 写满时容纳的元素数
+    double control_lines = 0.0;        // 每次操作触及的元数据缓存行
+    double data_lines = 0.0;           // 每次操作触及的元素缓存行（平均）
+    double throughput_ops_per_sec = 0.0;
+    
+    double bytes_per_element() const {
+        return max_in_flight ? static_cast<double>(resident_full_bytes) / max_in_flight : 0.0;
+    }
+};
+
+// 开始统计堆分配（测量期间没有其他线程在分配），返回值交给heap_bytes_since计算净增字节
+int64_t heap_bytes_in_use() {
+    bench_alloc::set_tracking(bench_alloc::kBytes);
+    return bench_alloc::bytes();
+}
+
+size_t heap_bytes_since(int64_t before) {
+    const int64_t now = bench_alloc::bytes();
+    return now > before ? static_cast<size_t>(now - before) : 0;
+}
+
+// 从缓存行起点开始连续存放时，单个元素平均跨越的缓存行数；元素起点每gcd个字节循环一次
+double average_lines_per_element(size_t bytes) {
+    const size_t period = kCacheLineBytes / std::gcd(bytes, kCacheLineBytes);
+    size_t lines = 0;
+    for (size_t i = 0; i < period; ++i) {
+        size_t offset = (i * bytes) % kCacheLineBytes;
+        lines += (offset + bytes - 1) / kCacheLineBytes + 1;
+    }
+    return static_cast<double>(lines) / period;
+}
+
+// 对象在其实际地址上跨越的缓存行数
+size_t lines_spanned(const void* object, size_t bytes) {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(object);
+    return (begin + bytes - 1) / kCacheLineBytes - begin / kCacheLineBytes + 1;
+}
+
+// 在堆上构造队列并写满，测量驻留字节和单次操作触及的缓存行
+// 缓存行数按数据布局计算：SPSC每次操作读写各自的索引行并读取对方的索引行，
+// 序号环每次操作只触及自己一端的位置行，满/空由槽位序号判断，序号与元素同在一个槽位中；
+// 双缓冲和有锁队列的元数据都在对象内，两端共享对象跨越的全部缓存行
+template<typename Queue, typename Data, typename Make>
+void measure_footprint(Make&& make, FootprintResult& result) {
+    const int64_t before = heap_bytes_in_use();
+    std::unique_ptr<Queue> queue = make();
+    result.object_bytes = sizeof(Queue);
+    result.resident_empty_bytes = heap_bytes_since(before);
+    
+    Data data;
+    size_t filled = 0;
+    while (queue->enqueue(data)) ++filled;
+    if constexpr (std::is_same<Queue, DoubleBufferSPSC<Data>>::value) {
+        // 读写两个缓冲区都写满才是双缓冲的最大积压
+        queue->swap_buffers();
+        while (queue->enqueue(data)) ++filled;
+    }
+    result.resident_full_bytes = heap_bytes_since(before);
+    result.max_in_flight = filled;
+    bench_alloc::set_tracking(0);
+    
+    result.data_lines = average_lines_per_element(sizeof(Data));
+    if constexpr (std::is_same<Queue, DoubleBufferSPSC<Data>>::value || std::is_same<Queue, LockedQueue<Data>>::value) {
+        result.control_lines = static_cast<double>(lines_spanned(queue.get(), sizeof(Queue)));
+    } else if constexpr (std::is_same<Queue, MPMCBoundedQueue<Data, true, false>>::value ||
+                         std::is_same<Queue, MPMCBoundedQueue<Data, true, true>>::value) {
+        result.control_lines = 1.0;
+        result.data_lines = average_lines_per_element(sizeof(std::atomic<size_t>) + sizeof(Data));
+    } else {
+        result.control_lines = 2.0;
+    }
+}
+
+template<typename Data>
+FootprintResult run_footprint(const std::string& queue_type, const BenchmarkConfig& config) {
+    FootprintResult result;
+    result.name = queue_display_name(queue_type);
+    result.queue_type = queue_type;
+    result.capacity = config.queue_size;
+    result.payload_bytes = sizeof(Data);
+    
+    if (queue_type == "locked") {
+        measure_footprint<LockedQueue<Data>, Data>([&]() {
+            return std::make_unique<LockedQueue<Data>>(config.queue_size);
+        }, result);
+    } else if (queue_type == "double_buffer") {
+        measure_footprint<DoubleBufferSPSC<Data>, Data>([&]() {
+            return std::make_unique<DoubleBufferSPSC<Data>>(config.queue_size);
+        }, result);
+    } else if (queue_type == "mpsc") {
+        measure_footprint<MPMCBoundedQueue<Data, true, false>, Data>([&]() {
+            return std::make_unique<MPMCBoundedQueue<Data, true, false>>(config.queue_size);
+        }, result);
+    } else if (queue_type == "mpmc") {
+        measure_footprint<MPMCBoundedQueue<Data, true, true>, Data>([&]() {
+            return std::make_unique<MPMCBoundedQueue<Data, true, true>>(config.queue_size);
+        }, result);
+    } else if (queue_type == "spsc_stats") {
+        dispatch_size(config.queue_size, SupportedCapacities{}, [&](auto size) {
+            using Queue = SPSCLockFreeQueue<Data, decltype(size)::value, SPSCQueueStats>;
+            measure_footprint<Queue, Data>([]() { return std::make_unique<Queue>(); }, result);
+        });
+    } else {
+        dispatch_size(config.queue_size, SupportedCapacities{}, [&](auto size) {
+            using Queue = SPSCLockFreeQueue<Data, decltype(size)::value>;
+            measure_footprint<Queue, Data>([]() { return std::make_unique<Queue>(); }, result);
+        });
+    }
+    
+    result.throughput_ops_per_sec = run_case_with_payload<Data>(queue_type, config).avg_throughput_ops_per_sec;
+    return result;
+}
+
+void print_footprint_results(const std::vector<FootprintResult>& results) {
+    std::cout << "\n" << std::string(146, '=') << std::endl;
+    std::cout << "内存占用与缓存行统计（驻留字节按分配块实际大小统计，缓存行数按数据布局计算）" << std::endl;
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << std::left << std::setw(22) << "队列类型"
+              << std::setw(10) << "容量"
+              << std::setw(10) << "消息(B)"
+              << std::setw(12) << "对象(B)"
+              << std::setw(14) << "空驻留(B)"
+              << std::setw(14) << "满驻留(B)"
+              << std::setw(12) << "最大积压"
+              << std::setw(12) << "每元素(B)"
+              << std::setw(12) << "行/操作"
+              << std::setw(14) << "实例/MB"
+              << "吞吐量(ops/s)" << std::endl;
+    std::cout << std::string(146, '-') << std::endl;
+    
+    for (const auto& r : results) {
+        std::ostringstream lines_text;
+        lines_text << std::fixed << std::setprecision(1) << r.control_lines << "+" << r.data_lines;
+        
+        std::cout << std::setw(22) << r.name
+                  << std::setw(10) << r.capacity
+                  << std::setw(10) << r.payload_bytes
+                  << std::setw(12) << r.object_bytes
+                  << std::setw(14) << r.resident_empty_bytes
+                  << std::setw(14) << r.resident_full_bytes
+                  << std::setw(12) << r.max_in_flight
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.bytes_per_element()
+                  << std::setw(12) << lines_text.str()
+                  << std::setw(14) << (r.resident_full_bytes ? 1048576.0 / r.resident_full_bytes : 0.0)
+                  << std::setprecision(0) << r.throughput_ops_per_sec << std::endl;
+    }
+    std::cout << std::string(146, '=') << std::endl;
+    std::cout << "行/操作 = 元数据行+元素行；SPSC两端各写自己的索引行，序号环只触及自己一端的位置行，双缓冲和有锁队列两端共享对象内的全部元数据行" << std::endl;
+#ifndef __GLIBC__
+    std::cout << "当前平台无法读取分配块大小，驻留字节显示为0" << std::endl;
+#endif
+}
+
+bool write_footprint_json(const std::string& path, const std::vector<FootprintResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(2);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << json_escape(r.name) << "\""
+            << ", \"queue\": \"" << json_escape(r.queue_type) << "\""
+            << ", \"capacity\": " << r.capacity
+            << ", \"payload_bytes\": " << r.payload_bytes
+            << ", \"object_bytes\": " << r.object_bytes
+            << ", \"resident_empty_bytes\": " << r.resident_empty_bytes
+            << ", \"resident_full_bytes\": " << r.resident_full_bytes
+            << ", \"max_in_flight\": " << r.max_in_flight
+            << ", \"bytes_per_element\": " << r.bytes_per_element()
+            << ", \"control_lines_per_op\": " << r.control_lines
+            << ", \"data_lines_per_op\": " << r.data_lines
+            << ", \"throughput_ops\": " << r.throughput_ops_per_sec
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    return static_cast<bool>(out);
+}
+
+bool write_footprint_csv(const std::string& path, const std::vector<FootprintResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << std::fixed << std::setprecision(2);
+    out << "name,queue,capacity,payload_bytes,object_bytes,resident_empty_bytes,resident_full_bytes,"
+           "max_in_flight,bytes_per_element,control_lines_per_op,data_lines_per_op,throughput_ops\n";
+    for (const auto& r : results) {
+        out << r.name << ',' << r.queue_type << ',' << r.capacity << ',' << r.payload_bytes << ','
+            << r.object_bytes << ',' << r.resident_empty_bytes << ',' << r.resident_full_bytes << ','
+            << r.max_in_flight << ',' << r.bytes_per_element() << ',' << r.control_lines << ','
+            << r.data_lines << ',' << r.throughput_ops_per_sec << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// 开环模式：每个队列类型×容量×消息大小各扫描一条延迟-吞吐量曲线
+int run_open_loop_mode(CommandLineOptions& options) {
+    OpenLoopConfig& config = options.open_loop;
+    config.num_operations = options.operations.front();
+    config.num_runs = options.num_runs;
+    config.batch_size = options.batch_sizes.front();
+    
+    std::cout << "SPSC队列开环延迟测试" << std::endl;
+    std::cout << "  到达模型: " << config.arrival << "，每点消息数: " << config.num_operations
+              << "，运行次数: " << config.num_runs << std::endl;
+    
+    std::vector<OpenLoopResult> results;
+    for (size_t payload : options.payloads) {
+        for (size_t capacity : options.capacities) {
+            for (const auto& queue_type : options.queue_types) {
+                dispatch_size(payload, SupportedPayloads{}, [&](auto bytes) {
+                    sweep_open_loop<Payload<decltype(bytes)::value>>(config, queue_type, capacity, results);
+                });
+            }
+        }
+    }
+    
+    print_open_loop_results(config, results);
+    
+    if (!options.json_path.empty()) {
+        if (!write_open_loop_json(options.json_path, config, results)) {
+            std::cerr << "写入JSON失败: " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\n结果已写入 " << options.json_path << std::endl;
+    }
+    if (!options.csv_path.empty()) {
+        if (!write_open_loop_csv(options.csv_path, config, results)) {
+            std::cerr << "写入CSV失败: " << options.csv_path << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << options.csv_path << std::endl;
+    }
+    return 0;
+}
+
+// 流水线模式：每个队列类型×级数跑一次，观察跳数增加时延迟如何累积
+int run_pipeline_mode(CommandLineOptions& options) {
+    PipelineConfig& config = options.pipeline;
+    config.num_operations = options.operations.front();
+    config.batch_size = options.batch_sizes.front();
+    config.rate = options.open_loop.rates.empty() ? 0.0 : options.open_loop.rates.front();
+    
+    std::cout << "SPSC队列流水线测试" << std::endl;
+    std::cout << "  消息数: " << config.num_operations << "，每级计算(ns):";
+    for (double work : config.work_ns) std::cout << ' ' << work;
+    std::cout << std::endl;
+    
+    std::vector<PipelineResult> results;
+    for (size_t payload : options.payloads) {
+        for (size_t capacity : options.capacities) {
+            for (const auto& queue_type : options.queue_types) {
+                for (size_t stages : config.stage_counts) {
+                    std::cout << "\n正在测试 " << queue_type << " " << stages << " 级 (容量 " << capacity
+                              << ", 消息 " << payload << "B)..." << std::endl;
+                    dispatch_size(payload, SupportedPayloads{}, [&](auto bytes) {
+                        using Data = Payload<decltype(bytes)::value>;
+                        dispatch_queue<Data>(queue_type, capacity, [&](auto tag) {
+                            using Q = typename decltype(tag)::type;
+                            results.push_back(run_pipeline<Q, Data>(config, queue_type, capacity, stages));
+                        });
+                    });
+                }
+            }
+        }
+    }
+    
+    print_pipeline_results(results);
+    
+    if (!options.json_path.empty()) {
+        if (!write_pipeline_json(options.json_path, results)) {
+            std::cerr << "写入JSON失败: " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\n结果已写入 " << options.json_path << std::endl;
+    }
+    if (!options.csv_path.empty()) {
+        if (!write_pipeline_csv(options.csv_path, results)) {
+            std::cerr << "写入CSV失败: " << options.csv_path << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << options.csv_path << std::endl;
+    }
+    return 0;
+}
+
+// 停顿模式：每个队列类型×容量跑一次，比较背压下的拒绝率、积压深度和恢复时间
+int run_stall_mode(CommandLineOptions& options) {
+    StallConfig& config = options.stall;
+    config.num_operations = options.operations.front();
+    config.batch_size = options.batch_sizes.front();
+    if (!options.open_loop.rates.empty()) {
+        config.rate = options.open_loop.rates.front();
+    }
+    
+    std::cout << "SPSC队列消费者停顿测试" << std::endl;
+    
+    std::vector<StallResult> results;
+    for (size_t payload : options.payloads) {
+        for (size_t capacity : options.capacities) {
+            for (const auto& queue_type : options.queue_types) {
+                std::cout << "\n正在测试 " << queue_type << " (容量 " << capacity
+                          << ", 消息 " << payload << "B)..." << std::endl;
+                dispatch_size(payload, SupportedPayloads{}, [&](auto bytes) {
+                    using Data = Payload<decltype(bytes)::value>;
+                    dispatch_queue<Data>(queue_type, capacity, [&](auto tag) {
+                        using Q = typename decltype(tag)::type;
+                        results.push_back(run_stall<Q, Data>(config, queue_type, capacity));
+                    });
+                });
+            }
+        }
+    }
+    
+    print_stall_results(config, results);
+    
+    if (!options.json_path.empty()) {
+        if (!write_stall_json(options.json_path, config, results)) {
+            std::cerr << "写入JSON失败: " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\n结果已写入 " << options.json_path << std::endl;
+    }
+    if (!options.csv_path.empty()) {
+        if (!write_stall_csv(options.csv_path, config, results)) {
+            std::cerr << "写入CSV失败: " << options.csv_path << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << options.csv_path << std::endl;
+    }
+    return 0;
+}
+
+// 事件循环通知模式：每个容量×消息大小×速率分别用忙等和eventfd消费者各跑一次
+int run_notify_mode(CommandLineOptions& options) {
+    NotifyConfig& config = options.notify;
+    if (!options.open_loop.rates.empty()) {
+        config.rates = options.open_loop.rates;
+    }
+    
+    std::cout << "SPSC队列事件循环通知测试" << std::endl;
+    
+    std::vector<NotifyResult> results;
+    for (size_t payload : options.payloads) {
+        for (size_t capacity : options.capacities) {
+            for (double rate : config.rates) {
+                for (const char* waiter : {"spin", "eventfd"}) {
+                    std::cout << "\n正在测试 " << waiter << " (容量 " << capacity << ", 消息 " << payload
+                              << "B, 速率 " << std::fixed << std::setprecision(0) << rate << " ops/s)..." << std::endl;
+                    dispatch_size(payload, SupportedPayloads{}, [&](auto bytes) {
+                        dispatch_size(capacity, SupportedCapacities{}, [&](auto size) {
+                            using Data = Payload<decltype(bytes)::value>;
+                            results.push_back(run_notify<Data, decltype(size)::value>(config, rate, waiter));
+                        });
+                    });
+                }
+            }
+        }
+    }
+    
+    print_notify_results(results);
+    
+    size_t lost_wakeups = 0;
+    for (const auto& r : results) {
+        if (r.lost_wakeups > 0) {
+            std::cerr << "\n" << r.waiter << " (容量 " << r.capacity << ", 消息 " << r.payload_bytes << "B, 速率 "
+                      << std::fixed << std::setprecision(0) << r.rate << " ops/s) 有 " << r.lost_wakeups
+                      << " 次epoll_wait超时返回时队列非空，登记/通知丢失了唤醒" << std::endl;
+        }
+        lost_wakeups += r.lost_wakeups;
+    }
+    
+    if (!options.json_path.empty()) {
+        if (!write_notify_json(options.json_path, config, results)) {
+            std::cerr << "写入JSON失败: " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\n结果已写入 " << options.json_path << std::endl;
+    }
+    if (!options.csv_path.empty()) {
+        if (!write_notify_csv(options.csv_path, config, results)) {
+            std::cerr << "写入CSV失败: " << options.csv_path << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << options.csv_path << std::endl;
+    }
+    return lost_wakeups > 0 ? 1 : 0;
+}
+
+// 内存占用模式：每个队列类型×容量×消息大小测量一次驻留内存，并跑一遍吞吐量作对照
+int run_footprint_mode(CommandLineOptions& options) {
+    std::cout << "SPSC队列内存占用测试" << std::endl;
+    
+    std::vector<FootprintResult> results;
+    for (const auto& c : build_cases(options)) {
+        std::cout << "\n正在测试 " << c.queue_type << " (容量 " << c.config.queue_size
+                  << ", 消息 " << c.config.payload_bytes << "B)..." << std::endl;
+        dispatch_size(c.config.payload_bytes, SupportedPayloads{}, [&](auto bytes) {
+            results.push_back(run_footprint<Payload<decltype(bytes)::value>>(c.queue_type, c.config));
+        });
+    }
+    
+    print_footprint_results(results);
+    
+    if (!options.json_path.empty()) {
+        if (!write_footprint_json(options.json_path, results)) {
+            std::cerr << "写入JSON失败: " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\n结果已写入 " << options.json_path << std::endl;
+    }
+    if (!options.csv_path.empty()) {
+        if (!write_footprint_csv(options.csv_path, results)) {
+            std::cerr << "写入CSV失败: " << options.csv_path << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << options.csv_path << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    CommandLineOptions options;
+    if (!parse_command_line(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (options.mode == "openloop") {
+        return run_open_loop_mode(options);
+    }
+    if (options.mode == "pipeline") {
+        return run_pipeline_mode(options);
+    }
+    if (options.mode == "stall") {
+        return run_stall_mode(options);
+    }
+    if (options.mode == "footprint") {
+        return run_footprint_mode(options);
+    }
+    if (options.mode == "notify") {
+        return run_notify_mode(options);
+    }
+    
+    std::cout << "SPSC队列性能对比测试" << std::endl;
+    std::cout << "正在运行性能测试，请稍等..." << std::endl;
+    
+    // 先试探一次，权限不足时只提示一次并关闭采集
+    if (options.collect_perf) {
+        PerfCounterGroup probe(options.perf_hitm_event);
+        if (!probe.available()) {
+            std::cout << "\n硬件计数器不可用，已跳过采集: " << probe.error() << std::endl;
+            options.collect_perf = false;
+        }
+    }
+    
+    std::vector<BenchmarkResult> baseline;
+    std::vector<BenchmarkCase> cases;
+    if (!options.baseline_path.empty()) {
+        std::string error;
+        if (!load_json(options.baseline_path, baseline, error)) {
+            std::cerr << "读取基线失败: " << options.baseline_path << ": " << error << std::endl;
+            return 1;
+        }
+        if (baseline.empty() || !cases_from_baseline(baseline, cases)) {
+            std::cerr << "基线文件中没有可复现的用例" << std::endl;
+            return 1;
+        }
+        std::cout << "\n基线: " << options.baseline_path << "（" << cases.size() << " 个用例）" << std::endl;
+    } else {
+        cases = build_cases(options);
+        
+        std::cout << "\n测试配置：" << std::endl;
+        std::cout << "  操作次数: ";
+        for (size_t ops : options.operations) std::cout << ops << ' ';
+        std::cout << "\n  队列大小: ";
+        for (size_t capacity : options.capacities) std::cout << capacity << ' ';
+        std::cout << "\n  消息大小: ";
+        for (size_t payload : options.payloads) std::cout << payload << ' ';
+        std::cout << "\n  预热操作: " << options.warmup_operations << std::endl;
+        std::cout << "  运行次数: " << options.num_runs << std::endl;
+    }
+    
+    std::vector<BenchmarkResult> results;
+    
+    for (auto& c : cases) {
+        c.config.collect_perf = options.collect_perf;
+        c.config.perf_hitm_event = options.perf_hitm_event;
+        c.config.pop_bulk = options.pop_bulk;
+        
+        std::cout << "\n正在测试 " << c.queue_type << " (容量 " << c.config.queue_size
+                  << ", 消息 " << c.config.payload_bytes << "B, 操作 " << c.config.num_operations;
+        if (c.queue_type == "double_buffer") {
+            std::cout << ", 批大小 " << c.config.batch_size;
+        }
+        if (c.config.pop_bulk > 1) {
+            std::cout << ", 批量出队 " << c.config.pop_bulk;
+        }
+        std::cout << ")..." << std::endl;
+        results.push_back(run_case(c.queue_type, c.config));
+    }
+    
+    print_results(results);
+    
+    int miscounted_runs = 0;
+    for (const auto& r : results) {
+        if (r.miscounted_runs > 0) {
+            std::cerr << "\n" << r.name << " (容量 " << r.capacity << ", 消息 " << r.payload_bytes << "B) 有 "
+                      << r.miscounted_runs << " 轮消费者合计出队数不等于操作次数" << std::endl;
+        }
+        miscounted_runs += r.miscounted_runs;
+    }
+    
+    if (!options.json_path.empty()) {
+        if (!write_json(options.json_path, results)) {
+            std::cerr << "写入JSON失败: " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "\n结果已写入 " << options.json_path << std::endl;
+    }
+    if (!options.csv_path.empty()) {
+        if (!write_csv(options.csv_path, results)) {
+            std::cerr << "写入CSV失败: " << options.csv_path << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << options.csv_path << std::endl;
+    }
+    if (miscounted_runs > 0) {
+        return 1;  // 结果不可信，不再与基线比较
+    }
+    
+    if (!baseline.empty()) {
+        size_t regressions = compare_with_baseline(baseline, results, options.regression_threshold,
+                                                   options.significance);
+        if (regressions > 0) {
+            std::cout << "\n发现 " << regressions << " 个显著回退" << std::endl;
+            return 2;
+        }
+        std::cout << "\n未发现显著回退" << std::endl;
+    }
+    
+    return 0;
+}
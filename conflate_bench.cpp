@@ -0,0 +1,271 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "conflating_queue.hpp"
+#include "spsc_lockfree_queue.hpp"
+#include "bench_util.hpp"
+
+// 合并队列基准：生产者按Zipf分布选择品种，成批突发地发布报价（两批之间空闲gap-us），
+// 消费者处理每条消息耗时work-ns，跟不上突发时对比
+//   plain       SPSCLockFreeQueue<Update>，每条更新都交付，队列满时生产者等待
+//   conflating  ConflatingQueue<Quote>，同一品种尚未消费的旧报价被覆盖
+// 统计消费条数、消费时报价的年龄、生产结束后消费者拿到所有品种最新报价所需的时间和队列最大深度
+
+constexpr size_t kMaxKeys = 4096;
+
+struct Quote {
+    uint64_t sequence = 0;  // 全局更新序号
+    int64_t timestamp_ns = 0;
+    double bid = 0.0;
+    double ask = 0.0;
+};
+
+struct Update {
+    uint32_t key = 0;
+    Quote quote;
+};
+
+struct ConflateBenchConfig {
+    size_t keys = 1024;
+    size_t updates = 2000000;
+    size_t burst = 20000;
+    int gap_us = 2000;
+    int work_ns = 200;
+    std::vector<double> skews{0.8, 1.2};
+};
+
+struct ConflateBenchResult {
+    double produce_mops = 0.0;   // 生产者发布速率（含等待队列空位的时间）
+    size_t consumed = 0;
+    double age_p50_us = 0.0;
+    double age_p99_us = 0.0;
+    double drain_ms = 0.0;       // 生产结束到消费者拿到所有品种最新报价
+    size_t max_depth = 0;
+    bool valid = true;
+};
+
+// 按Zipf分布(指数skew)预先生成键序列，计时部分不含采样开销
+std::vector<uint32_t> zipf_keys(size_t keys, double skew, size_t count) {
+    std::vector<double> cdf(keys);
+    double sum = 0.0;
+    for (size_t i = 0; i < keys; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+        cdf[i] = sum;
+    }
+    std::vector<uint32_t> result(count);
+    uint64_t state = 0x2545f4914f6cdd1dull;
+    for (size_t i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const double u = static_cast<double>(state >> 11) / static_cast<double>(1ull << 53) * sum;
+        const size_t k = std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        result[i] = static_cast<uint32_t>(std::min(k, keys - 1));
+    }
+    return result;
+}
+
+// 两种队列的适配：publish由生产者调用，队列满时返回false；poll由消费者调用
+struct PlainChannel {
+    static constexpr const char* name = "plain";
+    SPSCLockFreeQueue<Update, 65536> queue;
+    
+    bool publish(uint32_t key, const Quote& quote) {
+        return queue.enqueue(Update{key, quote});
+    }
+    
+    bool poll(size_t& key, Quote& quote) {
+        Update update;
+        if (!queue.dequeue(update)) return false;
+        key = update.key;
+        quote = update.quote;
+        return true;
+    }
+    
+    size_t depth() const {
+        return queue.size();
+    }
+};
+
+struct ConflatingChannel {
+    static constexpr const char* name = "conflating";
+    ConflatingQueue<Quote, kMaxKeys> queue;
+    
+    bool publish(uint32_t key, const Quote& quote) {
+        return queue.enqueue(key, quote);
+    }
+    
+    bool poll(size_t& key, Quote& quote) {
+        return queue.dequeue(key, quote);
+    }
+    
+    size_t depth() const {
+        return queue.size();
+    }
+};
+
+template<typename Channel>
+ConflateBenchResult run_channel(const ConflateBenchConfig& config, const std::vector<uint32_t>& keys) {
+    auto channel = std::make_unique<Channel>();
+    ConflateBenchResult result;
+    
+    // 每个品种最后一次发布的序号，生产结束后消费者据此判断是否已拿到全部最新报价
+    std::vector<uint64_t> final_sequence(config.keys, 0);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        final_sequence[keys[i]] = i + 1;
+    }
+    
+    std::atomic<bool> producer_done{false};
+    int64_t drained_ns = 0;
+    std::vector<double> ages_us;
+    ages_us.reserve(keys.size());
+    
+    std::thread consumer([&]() {
+        std::vector<uint64_t> latest(config.keys, 0);
+        size_t outstanding = 0;  // 尚未拿到最新报价的品种数
+        for (size_t k = 0; k < config.keys; ++k) {
+            if (final_sequence[k] != 0) ++outstanding;
+        }
+        size_t key;
+        Quote quote;
+        while (outstanding > 0) {
+            const bool done = producer_done.load(std::memory_order_acquire);
+            result.max_depth = std::max(result.max_depth, channel->depth());
+            if (!channel->poll(key, quote)) {
+                if (done) {
+                    result.valid = false;  // 生产已结束、队列已空，仍有品种没拿到最新报价
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            ages_us.push_back((bench_util::steady_now_ns() - quote.timestamp_ns) / 1e3);
+            bench_util::busy_work(config.work_ns);
+            if (quote.sequence < latest[key]) {
+                result.valid = false;  // 同一品种的报价不能倒退
+            }
+            if (quote.sequence == final_sequence[key] && latest[key] != quote.sequence) {
+                --outstanding;
+            }
+            latest[key] = quote.sequence;
+            ++result.consumed;
+        }
+        drained_ns = bench_util::steady_now_ns();
+    });
+    
+    const int64_t begin = bench_util::steady_now_ns();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        Quote quote;
+        quote.sequence = i + 1;
+        quote.timestamp_ns = bench_util::steady_now_ns();
+        quote.bid = 100.0 + static_cast<double>(i % 97) * 0.01;
+        quote.ask = quote.bid + 0.01;
+        while (!channel->publish(keys[i], quote)) {
+            std::this_thread::yield();
+        }
+        if ((i + 1) % config.burst == 0 && config.gap_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(config.gap_us));
+        }
+    }
+    const int64_t end = bench_util::steady_now_ns();
+    producer_done.store(true, std::memory_order_release);
+    consumer.join();
+    
+    // 生产速率不计突发之间的空闲时间
+    const int64_t idle_ns = static_cast<int64_t>(keys.size() / config.burst) * config.gap_us * 1000;
+    result.produce_mops = keys.size() * 1e3 / std::max<int64_t>(1, end - begin - idle_ns);
+    result.drain_ms = std::max<int64_t>(0, drained_ns - end) / 1e6;
+    std::sort(ages_us.begin(), ages_us.end());
+    result.age_p50_us = bench_util::percentile(ages_us, 0.50);
+    result.age_p99_us = bench_util::percentile(ages_us, 0.99);
+    return result;
+}
+
+template<typename Channel>
+void report(const ConflateBenchConfig& config, double skew, const std::vector<uint32_t>& keys, int& exit_code) {
+    ConflateBenchResult r = run_channel<Channel>(config, keys);
+    if (!r.valid) {
+        std::cerr << Channel::name << " zipf=" << skew << ": 消费者没有拿到所有品种的最新报价或报价倒退" << std::endl;
+        exit_code = 1;
+        return;
+    }
+    std::ostringstream age;
+    age << std::fixed << std::setprecision(1) << r.age_p50_us << "/" << r.age_p99_us;
+    std::cout << std::setw(13) << Channel::name
+              << std::setw(7) << std::fixed << std::setprecision(2) << skew
+              << std::setw(13) << std::setprecision(2) << r.produce_mops
+              << std::setw(12) << r.consumed
+              << std::setw(25) << age.str()
+              << std::setw(12) << std::setprecision(2) << r.drain_ms
+              << r.max_depth << std::endl;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --keys=N             品种数（默认1024，最多" << kMaxKeys << "）\n"
+              << "  --updates=N          发布的报价总数（默认2000000）\n"
+              << "  --burst=N            每批突发的报价数（默认20000）\n"
+              << "  --gap-us=N           两批之间的空闲时间（默认2000）\n"
+              << "  --work-ns=N          消费者处理每条消息的耗时（默认200）\n"
+              << "  --zipf=LIST          Zipf分布指数列表，越大越集中于少数品种（默认0.8,1.2）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ConflateBenchConfig config;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--keys") {
+            config.keys = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--updates") {
+            config.updates = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--burst") {
+            config.burst = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--gap-us") {
+            config.gap_us = std::atoi(value.c_str());
+        } else if (key == "--work-ns") {
+            config.work_ns = std::atoi(value.c_str());
+        } else if (key == "--zipf") {
+            config.skews = bench_util::parse_double_list(value);
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (config.keys == 0 || config.keys > kMaxKeys || config.updates == 0 || config.burst == 0 ||
+        config.gap_us < 0 || config.skews.empty()) {
+        std::cerr << "参数超出范围（品种数为1到" << kMaxKeys << "，报价数和批大小为正）" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "合并队列基准（" << config.keys << "个品种，" << config.updates << "条报价，每批"
+              << config.burst << "条、间隔" << config.gap_us << "us，消费者每条" << config.work_ns << "ns）" << std::endl;
+    bench_util::print_rule(96);
+    bench_util::print_header({{"队列", 13}, {"zipf", 7}, {"生产(M/s)", 13}, {"消费条数", 12}, {"报价年龄p50/p99(us)", 25},
+                              {"排空(ms)", 12}, {"最大深度", 0}});
+    bench_util::print_rule(96, '-');
+    
+    int exit_code = 0;
+    for (double skew : config.skews) {
+        const std::vector<uint32_t> keys = zipf_keys(config.keys, skew, config.updates);
+        report<PlainChannel>(config, skew, keys, exit_code);
+        report<ConflatingChannel>(config, skew, keys, exit_code);
+    }
+    bench_util::print_rule(96);
+    
+    return exit_code;
+}
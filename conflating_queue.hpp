@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "seqlock.hpp"
+#include "spsc_lockfree_queue.hpp"
+
+// 合并队列（单生产者单消费者）：每个键有一个值槽位，键尚未被消费时生产者直接覆盖槽位中的值，
+// 键FIFO中只放"由干净变脏"的键，消费者按键变脏的顺序取到每个键的最新值
+//
+// 适用于行情等只关心最新值的场景：消费者跟不上时同一品种的旧报价被合并掉，不会堆积；
+// 内存占用由键的数量决定，与突发的消息量无关，入队永远不会因队列满而失败
+//
+// 键为[0, MaxKeys)内的整数（如品种编号）；T须可平凡复制，槽位用序号校验（seqlock）读取，
+// 生产者写入时不等待消费者
+template<typename T, size_t MaxKeys>
+class ConflatingQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static_assert(MaxKeys > 0 && MaxKeys < (size_t(1) << 31), "MaxKeys out of range");
+
+private:
+    // 键FIFO的大小：大于MaxKeys的最小2的幂（SPSCLockFreeQueue实际容量为Size-1）
+    static constexpr size_t fifo_size() {
+        size_t size = 2;
+        while (size <= MaxKeys) size <<= 1;
+        return size;
+    }
+    
+    struct alignas(64) Slot {  // 每个键独占缓存行，不同键的更新互不干扰
+        std::atomic<uint32_t> sequence{0};  // 奇数表示生产者正在写
+        std::atomic<bool> dirty{false};     // 键已在FIFO中、尚未被消费者取走
+        T value;
+    };
+    
+    struct alignas(64) ProducerData {
+        std::atomic<size_t> published{0};
+        std::atomic<size_t> conflated{0};  // 覆盖了尚未消费的值的次数
+    } producer_;
+    
+    struct alignas(64) ConsumerData {
+        std::atomic<size_t> delivered{0};
+    } consumer_;
+    
+    SPSCLockFreeQueue<uint32_t, fifo_size()> keys_;
+    Slot slots_[MaxKeys];
+    
+    static void bump(std::atomic<size_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+public:
+    using value_type = T;
+    
+    ConflatingQueue() = default;
+    ~ConflatingQueue() = default;
+    
+    // 禁止拷贝和移动
+    ConflatingQueue(const ConflatingQueue&) = delete;
+    ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+    ConflatingQueue(ConflatingQueue&&) = delete;
+    ConflatingQueue& operator=(ConflatingQueue&&) = delete;
+    
+    // 生产者端：更新key的值；key尚未被消费时只覆盖槽位。key越界时返回false
+    bool enqueue(size_t key, const T& value) {
+        if (key >= MaxKeys) {
+            return false;
+        }
+        Slot& slot = slots_[key];
+        const uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+        seqlock_detail::write(slot.sequence, seq + 1, [&] { std::memcpy(&slot.value, &value, sizeof(T)); });
+        
+        bump(producer_.published);
+        // 由干净变脏时才放入FIFO；每个键在FIFO中至多一次，所以FIFO不会满
+        if (slot.dirty.exchange(true, std::memory_order_acq_rel)) {
+            bump(producer_.conflated);
+        } else {
+            keys_.enqueue(static_cast<uint32_t>(key));
+        }
+        return true;
+    }
+    
+    // 消费者端：取出下一个变脏的键及其最新值，没有待处理的键时返回false
+    //
+    // 先清除dirty再读值：清除之后生产者的更新会重新入队该键，所以不会丢失最后一次更新；
+    // 清除与读值之间到达的更新会被本次读到，之后还会再交付一次同样的值
+    bool dequeue(size_t& key, T& value) {
+        uint32_t k;
+        if (!keys_.dequeue(k)) {
+            return false;
+        }
+        Slot& slot = slots_[k];
+        slot.dirty.exchange(false, std::memory_order_acq_rel);  // 读改写，与生产者的exchange同步
+        size_t retries = 0;  // 生产者正在写时重读，次数不统计
+        seqlock_detail::read(slot.sequence, [&] { std::memcpy(&value, &slot.value, sizeof(T)); }, retries);
+        key = k;
+        bump(consumer_.delivered);
+        return true;
+    }
+    
+    // 待处理的键数（近似值）
+    size_t size() const {
+        return keys_.size();
+    }
+    
+    bool empty() const {
+        return keys_.empty();
+    }
+    
+    static constexpr size_t max_keys() {
+        return MaxKeys;
+    }
+    
+    // 统计，可由任意线程读取
+    size_t published() const {
+        return producer_.published.load(std::memory_order_relaxed);
+    }
+    
+    size_t conflated() const {
+        return producer_.conflated.load(std::memory_order_relaxed);
+    }
+    
+    size_t delivered() const {
+        return consumer_.delivered.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,291 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <iomanip>
+#include <functional>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <utility>
+
+#include "spsc_lockfree_queue.hpp"
+#include "async_spsc_queue.hpp"
+#include "bench_util.hpp"
+
+// 协程队列基准：在单线程调度器上运行一个生产者协程和一个消费者协程，
+// 对比co_await挂起/唤醒与轮询（失败时让出调度器）两种等待方式的每元素开销
+
+// 最小的协程任务：创建后挂起，由调度器启动，结束后挂起等待销毁
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+    
+    // 禁止拷贝
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&&) = delete;
+    
+    std::coroutine_handle<> handle() const {
+        return handle_;
+    }
+    
+    bool done() const {
+        return handle_.done();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// 单线程调度器：就绪队列按轮次执行，本轮中新就绪的协程放到下一轮
+class Scheduler {
+private:
+    std::vector<std::coroutine_handle<>> ready_;
+    std::vector<std::coroutine_handle<>> running_;
+    size_t posts_ = 0;
+
+public:
+    Scheduler() {
+        ready_.reserve(16);
+        running_.reserve(16);
+    }
+    
+    void post(std::coroutine_handle<> handle) {
+        ready_.push_back(handle);
+        ++posts_;
+    }
+    
+    // co_await scheduler.yield() 让出执行权，下一轮再继续
+    auto yield() {
+        struct YieldAwaiter {
+            Scheduler& scheduler;
+            bool await_ready() const { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.post(handle); }
+            void await_resume() const {}
+        };
+        return YieldAwaiter{*this};
+    }
+    
+    void run() {
+        while (!ready_.empty()) {
+            running_.swap(ready_);
+            for (auto handle : running_) {
+                handle.resume();
+            }
+            running_.clear();
+        }
+    }
+    
+    size_t posts() const {
+        return posts_;
+    }
+};
+
+// 唤醒时把协程投递到调度器，而不是在对方的调用栈里直接恢复
+struct SchedulerResumer {
+    Scheduler* scheduler;
+    
+    void operator()(std::coroutine_handle<> handle) const {
+        scheduler->post(handle);
+    }
+};
+
+template<size_t Capacity>
+using AwaitQueue = AsyncSPSCQueue<uint64_t, Capacity, SchedulerResumer>;
+
+template<size_t Capacity>
+Task await_producer(AwaitQueue<Capacity>& queue, size_t items) {
+    for (size_t i = 0; i < items; ++i) {
+        co_await queue.push(i);
+    }
+}
+
+template<size_t Capacity>
+Task await_consumer(AwaitQueue<Capacity>& queue, size_t items, uint64_t& checksum) {
+    for (size_t i = 0; i < items; ++i) {
+        checksum += co_await queue.pop();
+    }
+}
+
+template<size_t Capacity>
+Task poll_producer(Scheduler& scheduler, SPSCLockFreeQueue<uint64_t, Capacity>& queue, size_t items) {
+    for (size_t i = 0; i < items; ++i) {
+        while (!queue.enqueue(i)) {
+            co_await scheduler.yield();
+        }
+    }
+}
+
+template<size_t Capacity>
+Task poll_consumer(Scheduler& scheduler, SPSCLockFreeQueue<uint64_t, Capacity>& queue, size_t items,
+                   uint64_t& checksum) {
+    uint64_t item = 0;
+    for (size_t i = 0; i < items; ++i) {
+        while (!queue.dequeue(item)) {
+            co_await scheduler.yield();
+        }
+        checksum += item;
+    }
+}
+
+// 一次测量的结果：每元素耗时和每元素的调度次数（挂起后被重新投递的次数）
+struct RunResult {
+    double ns_per_item = 0.0;
+    double posts_per_item = 0.0;
+    bool valid = true;
+};
+
+// 把两个任务投递到调度器并运行到结束；协程帧在计时前创建，只计传递元素的开销
+RunResult run_tasks(Scheduler& scheduler, size_t items, Task producer, Task consumer, uint64_t& checksum) {
+    auto begin = std::chrono::steady_clock::now();
+    scheduler.post(producer.handle());
+    scheduler.post(consumer.handle());
+    const size_t initial_posts = scheduler.posts();
+    scheduler.run();
+    auto end = std::chrono::steady_clock::now();
+    bench_util::do_not_optimize(checksum);
+    
+    RunResult result;
+    result.ns_per_item = std::chrono::duration<double, std::nano>(end - begin).count() / items;
+    result.posts_per_item = static_cast<double>(scheduler.posts() - initial_posts) / items;
+    result.valid = producer.done() && consumer.done() && checksum == items * (items - 1) / 2;
+    return result;
+}
+
+template<size_t Capacity>
+RunResult run_await(size_t items) {
+    Scheduler scheduler;
+    AwaitQueue<Capacity> queue(SchedulerResumer{&scheduler});
+    uint64_t checksum = 0;
+    return run_tasks(scheduler, items, await_producer<Capacity>(queue, items),
+                     await_consumer<Capacity>(queue, items, checksum), checksum);
+}
+
+template<size_t Capacity>
+RunResult run_poll(size_t items) {
+    Scheduler scheduler;
+    SPSCLockFreeQueue<uint64_t, Capacity> queue;
+    uint64_t checksum = 0;
+    return run_tasks(scheduler, items, poll_producer<Capacity>(scheduler, queue, items),
+                     poll_consumer<Capacity>(scheduler, queue, items, checksum), checksum);
+}
+
+// 不经过协程的直接调用作为下限：生产者写满后消费者读空
+template<size_t Capacity>
+RunResult run_direct(size_t items) {
+    SPSCLockFreeQueue<uint64_t, Capacity> queue;
+    uint64_t checksum = 0;
+    uint64_t item = 0;
+    
+    auto begin = std::chrono::steady_clock::now();
+    size_t produced = 0;
+    while (produced < items) {
+        while (produced < items && queue.enqueue(produced)) ++produced;
+        while (queue.dequeue(item)) checksum += item;
+    }
+    auto end = std::chrono::steady_clock::now();
+    bench_util::do_not_optimize(checksum);
+    
+    RunResult result;
+    result.ns_per_item = std::chrono::duration<double, std::nano>(end - begin).count() / items;
+    result.valid = checksum == items * (items - 1) / 2;
+    return result;
+}
+
+struct CoroBenchmark {
+    std::string name;
+    std::function<RunResult(size_t)> run;
+};
+
+std::vector<CoroBenchmark> make_benchmarks() {
+    return {
+        {"direct/cap16", run_direct<16>},
+        {"poll/cap16", run_poll<16>},
+        {"await/cap16", run_await<16>},
+        {"direct/cap1024", run_direct<1024>},
+        {"poll/cap1024", run_poll<1024>},
+        {"await/cap1024", run_await<1024>},
+    };
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --filter=STR         只运行名称包含STR的测试\n"
+              << "  --items=N            每次测量传递的元素数（默认1000000）\n"
+              << "  --repetitions=N      每项重复测量次数（默认9）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    size_t items = 1000000;
+    int repetitions = 9;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--filter") {
+            filter = value;
+        } else if (key == "--items") {
+            items = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--repetitions") {
+            repetitions = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (items == 0 || repetitions <= 0) {
+        std::cerr << "元素数和重复次数必须为正" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "协程队列基准（单线程调度器，每次 " << items << " 个元素，重复 " << repetitions << " 次）" << std::endl;
+    bench_util::print_rule(80);
+    bench_util::print_header({{"名称", 20}, {"中位数(ns/元素)", 16}, {"最小(ns/元素)", 16}, {"调度次数/元素", 0}});
+    bench_util::print_rule(80, '-');
+    
+    int exit_code = 0;
+    for (const auto& bench : make_benchmarks()) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+        
+        std::vector<double> per_item;
+        double posts_per_item = 0.0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            RunResult r = bench.run(items);
+            if (!r.valid) {
+                std::cerr << bench.name << ": 元素丢失或任务未完成" << std::endl;
+                exit_code = 1;
+            }
+            per_item.push_back(r.ns_per_item);
+            posts_per_item = r.posts_per_item;
+        }
+        std::sort(per_item.begin(), per_item.end());
+        
+        std::cout << std::setw(20) << bench.name
+                  << std::setw(16) << std::fixed << std::setprecision(2) << bench_util::median(per_item)
+                  << std::setw(16) << per_item.front()
+                  << std::setprecision(4) << posts_per_item << std::endl;
+    }
+    bench_util::print_rule(80);
+    
+    return exit_code;
+}
@@ -17,6 +17,8 @@ private:
     size_t max_size_;
     
 public:
+    using value_type = T;
+    
     explicit DoubleBufferSPSC(size_t max_size = 1024) 
         : max_size_(max_size) {
         buffer1_.reserve(max_size);
@@ -44,6 +46,15 @@ public:
         return true;
     }
     
+    // 生产者端：批量写入，返回实际写入数量
+    size_t enqueue_bulk(const T* items, size_t count) {
+        auto* current_write_buffer = write_buffer_.load(std::memory_order_acquire);
+        const size_t room = max_size_ - current_write_buffer->size();
+        const size_t n = count < room ? count : room;
+        current_write_buffer->insert(current_write_buffer->end(), items, items + n);
+        return n;
+    }
+    
     // 生产者端：切换缓冲区
     void swap_buffers() {
         auto* current_write = write_buffer_.load(std::memory_order_acquire);
@@ -74,6 +85,20 @@ public:
         return true;
     }
     
+    // 消费者端：批量读取，返回实际读取数量
+    size_t dequeue_bulk(T* items, size_t max_count) {
+        auto* current_read_buffer = read_buffer_.load(std::memory_order_acquire);
+        size_t current_read_index = read_index_.load(std::memory_order_relaxed);
+        const size_t available = current_read_buffer->size() - current_read_index;
+        const size_t n = max_count < available ? max_count : available;
+        
+        for (size_t i = 0; i < n; ++i) {
+            items[i] = std::move((*current_read_buffer)[current_read_index + i]);
+        }
+        read_index_.store(current_read_index + n, std::memory_order_release);
+        return n;
+    }
+    
     // 检查是否有新数据可读
     bool has_data() const {
         auto* current_read_buffer = read_buffer_.load(std::memory_order_acquire);
@@ -100,6 +125,11 @@ public:
         return current_read_buffer->size() - current_read_index;
     }
     
+    // 获取当前数据量（近似值）：尚未切换的写缓冲区加上读缓冲区剩余部分
+    size_t size() const {
+        return write_buffer_size() + read_buffer_remaining();
+    }
+    
     // 获取容量
     size_t capacity() const {
         return max_size_;
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include "spsc_lockfree_queue.hpp"
+
+// eventfd通知器：生产者写入使fd可读，消费者在epoll报告可读后读出清零
+// 打开失败时available()为false，signal()/consume()为空操作，消费者应退回轮询
+class EventfdNotifier {
+private:
+    int fd_ = -1;
+    std::string error_;
+    std::atomic<size_t> signals_{0};  // 只由生产者写
+
+public:
+    EventfdNotifier() {
+#ifdef __linux__
+        fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd_ < 0) {
+            error_ = std::string("eventfd失败: ") + strerror(errno);
+        }
+#else
+        error_ = "当前平台不支持eventfd";
+#endif
+    }
+    
+    ~EventfdNotifier() {
+#ifdef __linux__
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+    
+    // 禁止拷贝和移动
+    EventfdNotifier(const EventfdNotifier&) = delete;
+    EventfdNotifier& operator=(const EventfdNotifier&) = delete;
+    EventfdNotifier(EventfdNotifier&&) = delete;
+    EventfdNotifier& operator=(EventfdNotifier&&) = delete;
+    
+    bool available() const {
+        return fd_ >= 0;
+    }
+    
+    const std::string& error() const {
+        return error_;
+    }
+    
+    // 注册到epoll的文件描述符
+    int fd() const {
+        return fd_;
+    }
+    
+    // 生产者端：计数器加1，fd变为可读
+    void signal() {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        const uint64_t one = 1;
+        ssize_t n = write(fd_, &one, sizeof(one));
+        (void)n;  // 计数器溢出前不会失败（EAGAIN只在累计到2^64-2时出现）
+        signals_.store(signals_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#endif
+    }
+    
+    // 消费者端：读出并清零计数器，返回自上次读取以来的信号数
+    uint64_t consume() {
+        uint64_t value = 0;
+#ifdef __linux__
+        if (fd_ < 0) return 0;
+        if (read(fd_, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+            return 0;  // EAGAIN：没有未读信号
+        }
+#endif
+        return value;
+    }
+    
+    // 累计写入次数（即生产者发起的系统调用数）
+    size_t signals() const {
+        return signals_.load(std::memory_order_relaxed);
+    }
+};
+
+// 可接入epoll事件循环的SPSC队列
+//
+// 消费者不能阻塞在队列上（还要处理socket和定时器），读空队列后调用arm()登记“即将休眠”，
+// 然后把fd()和其他描述符一起交给epoll_wait；生产者只在消费者已登记时才写eventfd，
+// 并且只写一次（用exchange取走登记），消费者忙碌期间入队没有系统调用
+//
+//   for (;;) {
+//       while (size_t n = queue.dequeue_bulk(batch, 64)) process(batch, n);
+//       if (!queue.arm()) continue;          // 登记期间有新数据，继续处理
+//       epoll_wait(...);
+//       if (eventfd可读) queue.acknowledge();
+//   }
+//
+// 登记与入队之间的竞争：消费者先写标志再检查队列，生产者先发布数据再读标志，
+// 两边之间各有一个seq_cst栅栏，保证数据不会在消费者休眠期间无人通知
+template<typename T, size_t Size, typename Stats = SPSCNoStats>
+class EventfdSPSCQueue {
+private:
+    SPSCLockFreeQueue<T, Size, Stats> queue_;
+    
+    alignas(64) std::atomic<bool> armed_{false};  // 消费者已读空并准备进入epoll_wait
+    
+    EventfdNotifier notifier_;
+    
+    // 生产者端：消费者已登记时取走登记并写eventfd
+    void notify_if_armed() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (armed_.load(std::memory_order_relaxed) && armed_.exchange(false, std::memory_order_relaxed)) {
+            notifier_.signal();
+        }
+    }
+
+public:
+    using value_type = T;
+    
+    EventfdSPSCQueue() = default;
+    
+    // 禁止拷贝和移动
+    EventfdSPSCQueue(const EventfdSPSCQueue&) = delete;
+    EventfdSPSCQueue& operator=(const EventfdSPSCQueue&) = delete;
+    EventfdSPSCQueue(EventfdSPSCQueue&&) = delete;
+    EventfdSPSCQueue& operator=(EventfdSPSCQueue&&) = delete;
+    
+    // 生产者端：入队操作
+    template<typename U>
+    bool enqueue(U&& item) {
+        if (!queue_.enqueue(std::forward<U>(item))) {
+            return false;
+        }
+        notify_if_armed();
+        return true;
+    }
+    
+    // 生产者端：批量入队，整批最多通知一次
+    size_t enqueue_bulk(const T* items, size_t count) {
+        const size_t n = queue_.enqueue_bulk(items, count);
+        if (n > 0) {
+            notify_if_armed();
+        }
+        return n;
+    }
+    
+    // 消费者端：出队操作
+    bool dequeue(T& item) {
+        return queue_.dequeue(item);
+    }
+    
+    // 消费者端：批量出队
+    size_t dequeue_bulk(T* items, size_t max_count) {
+        return queue_.dequeue_bulk(items, max_count);
+    }
+    
+    // 消费者端：进入epoll_wait前调用
+    // 返回true表示已登记，队列为空，可以等待fd()可读；返回false表示队列中已有数据，应继续处理
+    bool arm() {
+        armed_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.empty()) {
+            return true;
+        }
+        // 撤销登记；生产者若已取走登记，会多写一次eventfd，只造成一次空唤醒
+        armed_.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    
+    // 消费者端：epoll报告fd()可读后调用，清零eventfd计数器
+    uint64_t acknowledge() {
+        return notifier_.consume();
+    }
+    
+    int fd() const {
+        return notifier_.fd();
+    }
+    
+    const EventfdNotifier& notifier() const {
+        return notifier_;
+    }
+    
+    bool empty() const {
+        return queue_.empty();
+    }
+    
+    size_t size() const {
+        return queue_.size();
+    }
+    
+    static constexpr size_t capacity() {
+        return SPSCLockFreeQueue<T, Size, Stats>::capacity();
+    }
+    
+    SPSCQueueStatsSnapshot snapshot() const {
+        return queue_.snapshot();
+    }
+};
@@ -6,6 +6,7 @@
 #include "spsc_lockfree_queue.hpp"
 #include "locked_queue.hpp"
 #include "double_buffer_spsc.hpp"
+#include "queue_tracer.hpp"
 
 // 简单的演示数据
 struct Message {
@@ -156,6 +157,47 @@ void demo_double_buffer() {
     consumer.join();
 }
 
+// 采样跟踪演示
+void demo_traced_queue() {
+    std::cout << "\n=== 采样跟踪演示 ===" << std::endl;
+    
+    // 每100条消息采样1条，导出为Chrome trace JSON
+    QueueTracer tracer("queue_trace.json", TraceFormat::ChromeJson);
+    TracedQueue<SPSCLockFreeQueue<int, 64>> queue(tracer, "orders", 100);
+    if (!tracer.start()) {
+        std::cout << "无法创建跟踪文件" << std::endl;
+        return;
+    }
+    
+    const int total = 10000;
+    std::thread producer([&]() {
+        for (int i = 0; i < total; ++i) {
+            while (!queue.enqueue(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    std::thread consumer([&]() {
+        int value = 0;
+        int received = 0;
+        while (received < total) {
+            if (queue.dequeue(value)) {
+                received++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    producer.join();
+    consumer.join();
+    tracer.stop();
+    
+    std::cout << "共传输 " << total << " 条消息，导出 " << tracer.exported()
+              << " 条采样记录到 queue_trace.json（丢弃 " << tracer.dropped() << " 条）" << std::endl;
+}
+
 int main() {
     std::cout << "SPSC队列实现演示" << std::endl;
     std::cout << "==================" << std::endl;
@@ -168,6 +210,9 @@ int main() {
     std::this_thread::sleep_for(std::chrono::seconds(1));
     
     demo_double_buffer();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    
+    demo_traced_queue();
     
     std::cout << "\n演示完成！" << std::endl;
     return 0;
@@ -0,0 +1,292 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "locked_queue.hpp"
+#include "work_stealing_executor.hpp"
+#include "bench_alloc.hpp"
+#include "bench_util.hpp"
+
+// 线程池基准：WorkStealingExecutor与LockedQueue<std::function<void()>>共享队列线程池对比
+//   external  主线程连续提交任务，测任务吞吐量
+//   spawn     任务内部递归提交二叉树形子任务，测本地提交路径的吞吐量
+//   latency   主线程逐个提交任务并在两次提交之间空闲，测提交到开始执行的延迟（含唤醒）
+//
+// 任务捕获24字节（超过libstdc++中std::function的16字节内联存储），另外统计每个任务的堆分配次数
+
+// 对照组：所有线程阻塞在同一个LockedQueue上，空的std::function作为退出信号
+// 工作线程提交时队列已满则直接执行，否则所有工作线程都会卡在提交上
+class LockedPool {
+private:
+    LockedQueue<std::function<void()>> queue_;
+    std::vector<std::thread> threads_;
+    
+    static bool& on_worker() {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+public:
+    explicit LockedPool(size_t threads, size_t capacity = 1 << 16) : queue_(capacity) {
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this]() {
+                on_worker() = true;
+                std::function<void()> task;
+                while (true) {
+                    queue_.dequeue_blocking(task);
+                    if (!task) break;
+                    task();
+                }
+            });
+        }
+    }
+    
+    ~LockedPool() {
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            while (!queue_.enqueue(std::function<void()>())) std::this_thread::yield();
+        }
+        for (auto& t : threads_) t.join();
+    }
+    
+    // 禁止拷贝和移动
+    LockedPool(const LockedPool&) = delete;
+    LockedPool& operator=(const LockedPool&) = delete;
+    LockedPool(LockedPool&&) = delete;
+    LockedPool& operator=(LockedPool&&) = delete;
+    
+    static const char* name() {
+        return "locked";
+    }
+    
+    template<typename F>
+    void submit(F&& f) {
+        std::function<void()> task(std::forward<F>(f));
+        while (!queue_.enqueue(std::move(task))) {
+            if (on_worker()) {
+                task();
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+};
+
+class StealingExecutor : public WorkStealingExecutor {
+public:
+    using WorkStealingExecutor::WorkStealingExecutor;
+    
+    static const char* name() {
+        return "stealing";
+    }
+};
+
+void wait_for(const std::atomic<size_t>& counter, size_t target) {
+    while (counter.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+struct BenchConfig {
+    std::vector<size_t> threads{1, 2, 4};
+    size_t tasks = 1000000;
+    int depth = 18;
+    size_t samples = 2000;
+    int gap_us = 200;
+    int repetitions = 3;
+};
+
+struct BenchResult {
+    double mops = 0.0;            // 吞吐量（百万任务/秒，取最好的一次）
+    double allocs_per_task = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+// 主线程连续提交tasks个任务
+template<typename Pool>
+BenchResult run_external(const BenchConfig& config, size_t threads) {
+    Pool pool(threads);
+    BenchResult result;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        std::atomic<size_t> done{0};
+        uint64_t sink = 0;
+        const size_t allocs_before = bench_alloc::allocations();
+        const int64_t begin = bench_util::steady_now_ns();
+        for (size_t i = 0; i < config.tasks; ++i) {
+            pool.submit([&done, &sink, i]() {
+                if (i == 0) sink = i;  // 只有一个任务写入，保证捕获不被优化掉
+                done.fetch_add(1, std::memory_order_release);
+            });
+        }
+        wait_for(done, config.tasks);
+        const int64_t elapsed = bench_util::steady_now_ns() - begin;
+        result.allocs_per_task = static_cast<double>(bench_alloc::allocations() - allocs_before) /
+                                 config.tasks;
+        result.mops = std::max(result.mops, config.tasks * 1e3 / elapsed);
+    }
+    return result;
+}
+
+template<typename Pool>
+void spawn_tree(Pool& pool, int depth, std::atomic<size_t>& done) {
+    if (depth > 0) {
+        Pool* p = &pool;
+        std::atomic<size_t>* d = &done;
+        pool.submit([p, d, depth]() { spawn_tree(*p, depth - 1, *d); });
+        pool.submit([p, d, depth]() { spawn_tree(*p, depth - 1, *d); });
+    }
+    done.fetch_add(1, std::memory_order_release);
+}
+
+// 根任务在池内递归提交满二叉树，共2^(depth+1)-1个任务
+template<typename Pool>
+BenchResult run_spawn(const BenchConfig& config, size_t threads) {
+    Pool pool(threads);
+    BenchResult result;
+    const size_t total = (size_t(2) << config.depth) - 1;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        std::atomic<size_t> done{0};
+        const size_t allocs_before = bench_alloc::allocations();
+        const int64_t begin = bench_util::steady_now_ns();
+        Pool* p = &pool;
+        std::atomic<size_t>* d = &done;
+        const int depth = config.depth;
+        pool.submit([p, d, depth]() { spawn_tree(*p, depth, *d); });
+        wait_for(done, total);
+        const int64_t elapsed = bench_util::steady_now_ns() - begin;
+        result.allocs_per_task = static_cast<double>(bench_alloc::allocations() - allocs_before) /
+                                 total;
+        result.mops = std::max(result.mops, total * 1e3 / elapsed);
+    }
+    return result;
+}
+
+// 逐个提交，记录提交到开始执行的延迟；两次提交之间空闲gap_us，工作线程有机会进入休眠
+template<typename Pool>
+BenchResult run_latency(const BenchConfig& config, size_t threads) {
+    Pool pool(threads);
+    std::vector<double> latencies_us;
+    latencies_us.reserve(config.samples);
+    std::atomic<size_t> done{0};
+    int64_t started_ns = 0;
+    for (size_t i = 0; i < config.samples; ++i) {
+        const int64_t submitted = bench_util::steady_now_ns();
+        pool.submit([&done, &started_ns]() {
+            started_ns = bench_util::steady_now_ns();
+            done.fetch_add(1, std::memory_order_release);
+        });
+        wait_for(done, i + 1);
+        latencies_us.push_back((started_ns - submitted) / 1e3);
+        if (config.gap_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(config.gap_us));
+        }
+    }
+    std::sort(latencies_us.begin(), latencies_us.end());
+    BenchResult result;
+    result.p50_us = bench_util::percentile(latencies_us, 0.50);
+    result.p99_us = bench_util::percentile(latencies_us, 0.99);
+    result.max_us = latencies_us.back();
+    return result;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --filter=STR         只运行名称包含STR的测试（如external、spawn、latency、stealing）\n"
+              << "  --threads=LIST       工作线程数列表（默认1,2,4）\n"
+              << "  --tasks=N            external测试提交的任务数（默认1000000）\n"
+              << "  --depth=N            spawn测试的二叉树深度（默认18）\n"
+              << "  --samples=N          latency测试的采样数（默认2000）\n"
+              << "  --gap-us=N           latency测试两次提交之间的空闲时间（默认200）\n"
+              << "  --repetitions=N      吞吐量测试重复次数，取最好的一次（默认3）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    std::string filter;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--filter") {
+            filter = value;
+        } else if (key == "--threads") {
+            config.threads = bench_util::parse_size_list(value);
+        } else if (key == "--tasks") {
+            config.tasks = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--depth") {
+            config.depth = std::atoi(value.c_str());
+        } else if (key == "--samples") {
+            config.samples = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--gap-us") {
+            config.gap_us = std::atoi(value.c_str());
+        } else if (key == "--repetitions") {
+            config.repetitions = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (config.threads.empty() || std::count(config.threads.begin(), config.threads.end(), 0u) > 0) {
+        std::cerr << "线程数必须为正" << std::endl;
+        return 1;
+    }
+    if (config.tasks == 0 || config.depth < 0 || config.depth > 30 || config.samples == 0 ||
+        config.gap_us < 0 || config.repetitions <= 0) {
+        std::cerr << "参数超出范围（任务数、采样数和重复次数为正，深度取0~30）" << std::endl;
+        return 1;
+    }
+    
+    struct Case {
+        std::string name;
+        bool latency;
+        BenchResult (*run)(const BenchConfig&, size_t);
+    };
+    const std::vector<Case> cases = {
+        {"external/" + std::string(StealingExecutor::name()), false, run_external<StealingExecutor>},
+        {"external/" + std::string(LockedPool::name()), false, run_external<LockedPool>},
+        {"spawn/" + std::string(StealingExecutor::name()), false, run_spawn<StealingExecutor>},
+        {"spawn/" + std::string(LockedPool::name()), false, run_spawn<LockedPool>},
+        {"latency/" + std::string(StealingExecutor::name()), true, run_latency<StealingExecutor>},
+        {"latency/" + std::string(LockedPool::name()), true, run_latency<LockedPool>},
+    };
+    
+    bench_alloc::set_tracking(bench_alloc::kCount);  // 统计每个任务的堆分配次数
+    
+    std::cout << "线程池基准（external " << config.tasks << " 个任务，spawn 深度" << config.depth
+              << "，latency " << config.samples << " 次采样、间隔" << config.gap_us << "us）" << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    bench_util::print_rule(88);
+    bench_util::print_header({{"名称", 20}, {"线程数", 9}, {"吞吐量(M/s) 或 p50/p99/max(us)", 34}, {"分配/任务", 0}});
+    bench_util::print_rule(88, '-');
+    
+    for (const auto& c : cases) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+        for (size_t threads : config.threads) {
+            BenchResult r = c.run(config, threads);
+            std::cout << std::setw(20) << c.name << std::setw(9) << threads << std::fixed;
+            if (c.latency) {
+                std::ostringstream cell;
+                cell << std::fixed << std::setprecision(1) << r.p50_us << "/" << r.p99_us << "/" << r.max_us;
+                std::cout << cell.str() << std::endl;
+            } else {
+                std::cout << std::setw(34) << std::setprecision(2) << r.mops
+                          << std::setprecision(3) << r.allocs_per_task << std::endl;
+            }
+        }
+    }
+    bench_util::print_rule(88);
+    
+    return 0;
+}
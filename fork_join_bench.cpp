@@ -0,0 +1,428 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "locked_queue.hpp"
+#include "work_stealing_deque.hpp"
+#include "bench_util.hpp"
+
+// fork-join基准：并行fib和并行快速排序，对比每线程Chase–Lev双端队列加窃取
+// 与所有线程共享一个LockedQueue任务池两种调度方式
+//
+// 任务对象分配在父任务的栈上，父任务spawn子任务后继续计算另一半，join时一边等待
+// 一边执行其他任务（帮助式等待），因此任意时刻只有叶子之外的少量任务在队列中
+
+// 任务基类：run由具体任务设置，执行完成后置done
+struct Job {
+    void (*run)(Job*, size_t worker) = nullptr;
+    size_t owner = 0;  // 创建任务的工作线程
+    std::atomic<bool> done{false};
+};
+
+// 每个工作线程的统计，只由该线程写
+struct alignas(64) WorkerStats {
+    std::atomic<size_t> executed{0};  // 执行的任务数
+    std::atomic<size_t> migrated{0};  // 其中由其他线程创建的任务数
+    
+    void record(const Job* job, size_t worker) {
+        executed.store(executed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (job->owner != worker) {
+            migrated.store(migrated.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+};
+
+// 线程池骨架：工作线程1..N-1循环取任务，调用方线程作为0号工作线程运行根任务
+// Derived提供spawn(worker, job)和find(worker, job)
+template<typename Derived>
+class PoolBase {
+protected:
+    std::vector<WorkerStats> stats_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+    
+    explicit PoolBase(size_t workers) : stats_(workers) {}
+    
+    void start() {
+        for (size_t i = 1; i < stats_.size(); ++i) {
+            threads_.emplace_back([this, i]() {
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    if (!run_one(i)) std::this_thread::yield();
+                }
+            });
+        }
+    }
+    
+    void stop() {
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto& t : threads_) t.join();
+    }
+
+public:
+    // 禁止拷贝和移动
+    PoolBase(const PoolBase&) = delete;
+    PoolBase& operator=(const PoolBase&) = delete;
+    PoolBase(PoolBase&&) = delete;
+    PoolBase& operator=(PoolBase&&) = delete;
+    
+    size_t workers() const {
+        return stats_.size();
+    }
+    
+    // 取一个任务执行，没有任务时返回false
+    bool run_one(size_t worker) {
+        Job* job = nullptr;
+        if (!static_cast<Derived*>(this)->find(worker, job)) {
+            return false;
+        }
+        execute(worker, job);
+        return true;
+    }
+    
+    void execute(size_t worker, Job* job) {
+        job->run(job, worker);
+        stats_[worker].record(job, worker);
+        job->done.store(true, std::memory_order_release);
+    }
+    
+    // 等待子任务完成，期间执行其他任务
+    void join(size_t worker, Job* job) {
+        while (!job->done.load(std::memory_order_acquire)) {
+            if (!run_one(worker)) std::this_thread::yield();
+        }
+    }
+    
+    // 累计执行的任务数和迁移比例，调用方在两次运行之间读取
+    size_t executed() const {
+        size_t total = 0;
+        for (const auto& s : stats_) total += s.executed.load(std::memory_order_relaxed);
+        return total;
+    }
+    
+    size_t migrated() const {
+        size_t total = 0;
+        for (const auto& s : stats_) total += s.migrated.load(std::memory_order_relaxed);
+        return total;
+    }
+    
+    void reset_stats() {
+        for (auto& s : stats_) {
+            s.executed.store(0, std::memory_order_relaxed);
+            s.migrated.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// 工作窃取：每个线程一个双端队列，本地后进先出，空闲时随机选一个线程从顶部窃取
+class StealingPool : public PoolBase<StealingPool> {
+private:
+    std::vector<std::unique_ptr<ChaseLevDeque<Job*>>> deques_;
+    std::vector<uint64_t> rng_;  // 每线程xorshift状态，只由该线程访问
+
+public:
+    explicit StealingPool(size_t workers) : PoolBase(workers) {
+        for (size_t i = 0; i < workers; ++i) {
+            deques_.push_back(std::make_unique<ChaseLevDeque<Job*>>(256));
+            rng_.push_back(0x9E3779B97F4A7C15ULL * (i + 1));
+        }
+        start();
+    }
+    
+    ~StealingPool() {
+        stop();
+    }
+    
+    static const char* name() {
+        return "stealing";
+    }
+    
+    void spawn(size_t worker, Job* job) {
+        job->owner = worker;
+        deques_[worker]->push(job);
+    }
+    
+    bool find(size_t worker, Job*& job) {
+        if (deques_[worker]->pop(job)) {
+            return true;
+        }
+        const size_t n = deques_.size();
+        if (n == 1) {
+            return false;
+        }
+        uint64_t& x = rng_[worker];
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const size_t start = static_cast<size_t>(x % n);
+        for (size_t k = 0; k < n; ++k) {
+            const size_t victim = (start + k) % n;
+            if (victim != worker && deques_[victim]->steal(job)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// 共享任务池：所有线程从同一个LockedQueue存取任务，队列满时在当前线程直接执行
+class SharedPool : public PoolBase<SharedPool> {
+private:
+    LockedQueue<Job*> queue_;
+
+public:
+    explicit SharedPool(size_t workers) : PoolBase(workers), queue_(1 << 16) {
+        start();
+    }
+    
+    ~SharedPool() {
+        stop();
+    }
+    
+    static const char* name() {
+        return "locked";
+    }
+    
+    void spawn(size_t worker, Job* job) {
+        job->owner = worker;
+        if (!queue_.enqueue(job)) {
+            execute(worker, job);
+        }
+    }
+    
+    bool find(size_t, Job*& job) {
+        return queue_.dequeue(job);
+    }
+};
+
+// ==================== 并行fib ====================
+
+uint64_t fib_serial(int n) {
+    return n < 2 ? static_cast<uint64_t>(n) : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+template<typename Pool>
+uint64_t fib_parallel(Pool& pool, size_t worker, int n, int cutoff);
+
+template<typename Pool>
+struct FibJob : Job {
+    Pool* pool;
+    int n;
+    int cutoff;
+    uint64_t result = 0;
+    
+    FibJob(Pool* p, int value, int cut) : pool(p), n(value), cutoff(cut) {
+        run = [](Job* job, size_t worker) {
+            auto* self = static_cast<FibJob*>(job);
+            self->result = fib_parallel(*self->pool, worker, self->n, self->cutoff);
+        };
+    }
+};
+
+template<typename Pool>
+uint64_t fib_parallel(Pool& pool, size_t worker, int n, int cutoff) {
+    if (n < cutoff) {
+        return fib_serial(n);
+    }
+    FibJob<Pool> child(&pool, n - 1, cutoff);
+    pool.spawn(worker, &child);
+    const uint64_t right = fib_parallel(pool, worker, n - 2, cutoff);
+    pool.join(worker, &child);
+    return child.result + right;
+}
+
+// ==================== 并行快速排序 ====================
+
+template<typename Pool>
+void sort_parallel(Pool& pool, size_t worker, uint32_t* first, uint32_t* last, size_t cutoff);
+
+template<typename Pool>
+struct SortJob : Job {
+    Pool* pool;
+    uint32_t* first;
+    uint32_t* last;
+    size_t cutoff;
+    
+    SortJob(Pool* p, uint32_t* f, uint32_t* l, size_t cut) : pool(p), first(f), last(l), cutoff(cut) {
+        run = [](Job* job, size_t worker) {
+            auto* self = static_cast<SortJob*>(job);
+            sort_parallel(*self->pool, worker, self->first, self->last, self->cutoff);
+        };
+    }
+};
+
+template<typename Pool>
+void sort_parallel(Pool& pool, size_t worker, uint32_t* first, uint32_t* last, size_t cutoff) {
+    if (static_cast<size_t>(last - first) <= cutoff) {
+        std::sort(first, last);
+        return;
+    }
+    // 三路划分，重复元素较多时也能保证两侧都变短
+    const uint32_t pivot = first[(last - first) / 2];
+    uint32_t* lower = std::partition(first, last, [pivot](uint32_t v) { return v < pivot; });
+    uint32_t* upper = std::partition(lower, last, [pivot](uint32_t v) { return v == pivot; });
+    
+    SortJob<Pool> child(&pool, first, lower, cutoff);
+    pool.spawn(worker, &child);
+    sort_parallel(pool, worker, upper, last, cutoff);
+    pool.join(worker, &child);
+}
+
+// ==================== 测量 ====================
+
+struct ForkJoinConfig {
+    std::vector<size_t> threads{1, 2, 4};
+    int fib_n = 32;
+    int fib_cutoff = 16;
+    size_t sort_size = 4u << 20;
+    size_t sort_cutoff = 4096;
+    int repetitions = 5;
+};
+
+struct ForkJoinResult {
+    std::vector<double> ms;
+    size_t tasks = 0;
+    double migrated_ratio = 0.0;
+    bool valid = true;
+};
+
+template<typename Pool>
+ForkJoinResult measure_fib(const ForkJoinConfig& config, size_t threads) {
+    const uint64_t expected = fib_serial(config.fib_n);
+    Pool pool(threads);
+    ForkJoinResult result;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        pool.reset_stats();
+        auto begin = std::chrono::steady_clock::now();
+        const uint64_t value = fib_parallel(pool, 0, config.fib_n, config.fib_cutoff);
+        auto end = std::chrono::steady_clock::now();
+        result.ms.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+        result.valid = result.valid && value == expected;
+    }
+    result.tasks = pool.executed();
+    result.migrated_ratio = result.tasks > 0 ? static_cast<double>(pool.migrated()) / result.tasks : 0.0;
+    return result;
+}
+
+template<typename Pool>
+ForkJoinResult measure_sort(const ForkJoinConfig& config, size_t threads) {
+    std::vector<uint32_t> input(config.sort_size);
+    std::mt19937 rng(42);
+    for (auto& v : input) v = rng();
+    
+    Pool pool(threads);
+    ForkJoinResult result;
+    std::vector<uint32_t> data;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        data = input;
+        pool.reset_stats();
+        auto begin = std::chrono::steady_clock::now();
+        sort_parallel(pool, 0, data.data(), data.data() + data.size(), config.sort_cutoff);
+        auto end = std::chrono::steady_clock::now();
+        result.ms.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+        result.valid = result.valid && std::is_sorted(data.begin(), data.end());
+    }
+    result.tasks = pool.executed();
+    result.migrated_ratio = result.tasks > 0 ? static_cast<double>(pool.migrated()) / result.tasks : 0.0;
+    return result;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --filter=STR         只运行名称包含STR的测试（如fib、sort、stealing、locked）\n"
+              << "  --threads=LIST       工作线程数列表（默认1,2,4）\n"
+              << "  --fib=N              计算fib(N)（默认32）\n"
+              << "  --fib-cutoff=N       n小于N时串行计算（默认16）\n"
+              << "  --sort=N             排序的元素数（默认4194304）\n"
+              << "  --sort-cutoff=N      区间不超过N个元素时串行排序（默认4096）\n"
+              << "  --repetitions=N      每项重复测量次数（默认5）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ForkJoinConfig config;
+    std::string filter;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--filter") {
+            filter = value;
+        } else if (key == "--threads") {
+            config.threads = bench_util::parse_size_list(value);
+        } else if (key == "--fib") {
+            config.fib_n = std::atoi(value.c_str());
+        } else if (key == "--fib-cutoff") {
+            config.fib_cutoff = std::atoi(value.c_str());
+        } else if (key == "--sort") {
+            config.sort_size = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--sort-cutoff") {
+            config.sort_cutoff = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--repetitions") {
+            config.repetitions = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (config.threads.empty() || std::count(config.threads.begin(), config.threads.end(), 0u) > 0) {
+        std::cerr << "线程数必须为正" << std::endl;
+        return 1;
+    }
+    if (config.fib_n < 0 || config.fib_n > 45 || config.fib_cutoff < 2 || config.sort_cutoff == 0 ||
+        config.repetitions <= 0) {
+        std::cerr << "参数超出范围（fib取0~45，串行阈值至少为2，排序阈值和重复次数为正）" << std::endl;
+        return 1;
+    }
+    
+    struct Case {
+        std::string name;
+        ForkJoinResult (*run)(const ForkJoinConfig&, size_t);
+    };
+    const std::vector<Case> cases = {
+        {"fib/" + std::string(StealingPool::name()), measure_fib<StealingPool>},
+        {"fib/" + std::string(SharedPool::name()), measure_fib<SharedPool>},
+        {"sort/" + std::string(StealingPool::name()), measure_sort<StealingPool>},
+        {"sort/" + std::string(SharedPool::name()), measure_sort<SharedPool>},
+    };
+    
+    std::cout << "fork-join基准（fib(" << config.fib_n << ")，阈值" << config.fib_cutoff
+              << "；排序" << config.sort_size << "个元素，阈值" << config.sort_cutoff
+              << "；重复 " << config.repetitions << " 次）" << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    bench_util::print_rule(88);
+    bench_util::print_header({{"名称", 20}, {"线程数", 9}, {"中位数(ms)", 14}, {"最小(ms)", 14}, {"任务数/次", 14},
+                              {"迁移比例", 0}});
+    bench_util::print_rule(88, '-');
+    
+    int exit_code = 0;
+    for (const auto& c : cases) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+        for (size_t threads : config.threads) {
+            ForkJoinResult r = c.run(config, threads);
+            if (!r.valid) {
+                std::cerr << c.name << "/" << threads << "t: 结果错误" << std::endl;
+                exit_code = 1;
+            }
+            std::sort(r.ms.begin(), r.ms.end());
+            std::cout << std::setw(20) << c.name
+                      << std::setw(9) << threads
+                      << std::setw(14) << std::fixed << std::setprecision(2) << bench_util::median(r.ms)
+                      << std::setw(14) << r.ms.front()
+                      << std::setw(14) << r.tasks
+                      << std::setprecision(1) << r.migrated_ratio * 100.0 << "%" << std::endl;
+        }
+    }
+    bench_util::print_rule(88);
+    
+    return exit_code;
+}
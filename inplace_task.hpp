@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 不分配内存的任务类型：可调用对象直接构造在对象内部的Capacity字节缓冲区中，
+// 放不下时编译报错（没有堆分配的退路），需要更大的捕获时增大Capacity
+//
+// 只能移动，可作为SPSCLockFreeQueue等队列的槽位类型：默认构造为空任务，移动后源对象为空。
+// 可平凡复制的可调用对象（只捕获指针、整数等的lambda）按字节搬运，移动就是一次memcpy，
+// 不经过间接调用；其他可调用对象通过管理函数移动构造和析构
+//
+// InplaceTask<48>正好占一个缓存行（48字节缓冲区加两个函数指针）
+template<size_t Capacity>
+class InplaceTask {
+    static_assert(Capacity >= sizeof(void*), "Capacity must hold at least a pointer");
+
+private:
+    enum class Op { Relocate, Destroy };
+    
+    using Invoke = void (*)(void* storage);
+    using Manage = void (*)(Op op, void* to, void* from);
+    
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    Invoke invoke_ = nullptr;
+    Manage manage_ = nullptr;  // 可平凡复制的可调用对象为nullptr
+    
+    template<typename F>
+    static void invoke_fn(void* storage) {
+        (*static_cast<F*>(storage))();
+    }
+    
+    template<typename F>
+    static void manage_fn(Op op, void* to, void* from) {
+        if (op == Op::Relocate) {
+            new (to) F(std::move(*static_cast<F*>(from)));
+        }
+        static_cast<F*>(from)->~F();
+    }
+    
+    void relocate_from(InplaceTask& other) noexcept {
+        invoke_ = other.invoke_;
+        manage_ = other.manage_;
+        if (manage_ == nullptr) {
+            std::memcpy(storage_, other.storage_, Capacity);
+        } else {
+            manage_(Op::Relocate, storage_, other.storage_);
+        }
+        other.invoke_ = nullptr;
+        other.manage_ = nullptr;
+    }
+
+public:
+    static constexpr size_t capacity = Capacity;
+    
+    // F能否放入InplaceTask<Capacity>
+    template<typename F>
+    static constexpr bool fits = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                                 std::is_nothrow_move_constructible<F>::value;
+    
+    // F是否按字节搬运
+    template<typename F>
+    static constexpr bool trivially_relocatable = std::is_trivially_copyable<F>::value;
+    
+    InplaceTask() noexcept = default;
+    
+    template<typename F, typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same<D, InplaceTask>::value>>
+    InplaceTask(F&& f) noexcept(std::is_nothrow_constructible<D, F&&>::value) {
+        static_assert(sizeof(D) <= Capacity, "callable is too large for InplaceTask<Capacity>, increase Capacity");
+        static_assert(alignof(D) <= alignof(std::max_align_t), "callable is over-aligned for InplaceTask");
+        static_assert(std::is_nothrow_move_constructible<D>::value, "callable must be nothrow move constructible");
+        new (storage_) D(std::forward<F>(f));
+        invoke_ = &invoke_fn<D>;
+        if constexpr (!trivially_relocatable<D>) {
+            manage_ = &manage_fn<D>;
+        }
+    }
+    
+    InplaceTask(InplaceTask&& other) noexcept {
+        if (other.invoke_ != nullptr) {
+            relocate_from(other);
+        }
+    }
+    
+    InplaceTask& operator=(InplaceTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.invoke_ != nullptr) {
+                relocate_from(other);
+            }
+        }
+        return *this;
+    }
+    
+    ~InplaceTask() {
+        reset();
+    }
+    
+    // 禁止拷贝
+    InplaceTask(const InplaceTask&) = delete;
+    InplaceTask& operator=(const InplaceTask&) = delete;
+    
+    explicit operator bool() const noexcept {
+        return invoke_ != nullptr;
+    }
+    
+    // 调用可调用对象，任务保持不变（可以重复调用）
+    void operator()() {
+        invoke_(storage_);
+    }
+    
+    // 销毁可调用对象，任务变为空
+    void reset() noexcept {
+        if (manage_ != nullptr) {
+            manage_(Op::Destroy, nullptr, storage_);
+        }
+        invoke_ = nullptr;
+        manage_ = nullptr;
+    }
+};
@@ -0,0 +1,246 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "journal_queue.hpp"
+#include "bench_util.hpp"
+
+// 日志队列基准：主线程作为写入方连续追加定长记录，另一线程作为读取方跟随读取，
+// 测追加吞吐量和读取方滞后（读到记录时刻减去写入时打的时间戳）
+
+struct JournalBenchConfig {
+    std::string directory = "/tmp/lfq_journal_bench";
+    size_t records = 5000000;
+    size_t always_records = 100000;  // Always模式每条记录都msync，单独限制记录数
+    uint32_t record_size = 64;
+    size_t file_mb = 64;
+    std::vector<JournalSync> syncs{JournalSync::None, JournalSync::Batch, JournalSync::Always};
+    size_t sync_interval = 1024;
+    bool prefault = false;
+};
+
+struct JournalBenchResult {
+    size_t records = 0;
+    double append_mops = 0.0;
+    double append_mbps = 0.0;
+    double lag_p50_us = 0.0;
+    double lag_p99_us = 0.0;
+    double lag_max_us = 0.0;
+    double catch_up_ms = 0.0;  // 写入结束后读取方追上所用的时间
+    uint64_t files = 0;
+    uint64_t syncs = 0;
+    bool valid = true;
+};
+
+const char* sync_name(JournalSync sync) {
+    switch (sync) {
+        case JournalSync::None: return "none";
+        case JournalSync::Batch: return "batch";
+        case JournalSync::Always: return "always";
+    }
+    return "?";
+}
+
+// 只删除本基准生成的日志文件
+void remove_journal_files(const std::string& directory) {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".journal") {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}
+
+JournalBenchResult run_journal(const JournalBenchConfig& config, JournalSync sync, std::string& error) {
+    JournalBenchResult result;
+    result.records = sync == JournalSync::Always ? std::min(config.records, config.always_records) : config.records;
+    
+    remove_journal_files(config.directory);
+    JournalConfig journal_config;
+    journal_config.directory = config.directory;
+    journal_config.file_size = config.file_mb << 20;
+    journal_config.sync = sync;
+    journal_config.sync_interval = config.sync_interval;
+    journal_config.prefault = config.prefault;
+    
+    JournalWriter writer(journal_config);
+    if (!writer.available()) {
+        error = writer.error();
+        result.valid = false;
+        return result;
+    }
+    
+    // 读取方：每条记录前16字节为序号和写入时间戳
+    std::vector<double> lags_us;
+    lags_us.reserve(result.records);
+    std::atomic<bool> tailer_ready{false};
+    std::atomic<bool> stop{false};  // 写入失败时通知读取方退出
+    std::atomic<int64_t> tailer_done_ns{0};
+    bool sequence_ok = true;  // 只由读取方写入，join之后才合并到结果
+    std::thread tailer_thread([&]() {
+        JournalTailer tailer(config.directory);
+        tailer_ready.store(true, std::memory_order_release);
+        const void* data = nullptr;
+        uint32_t size = 0;
+        uint64_t expected = 0;
+        while (expected < result.records && !stop.load(std::memory_order_relaxed)) {
+            if (!tailer.read(data, size)) {
+                std::this_thread::yield();
+                continue;
+            }
+            const int64_t now = bench_util::steady_now_ns();
+            uint64_t header[2];
+            std::memcpy(header, data, sizeof(header));
+            if (header[0] != expected || size != config.record_size) {
+                sequence_ok = false;
+            }
+            lags_us.push_back((now - static_cast<int64_t>(header[1])) / 1e3);
+            ++expected;
+        }
+        tailer_done_ns.store(bench_util::steady_now_ns(), std::memory_order_release);
+    });
+    while (!tailer_ready.load(std::memory_order_acquire)) std::this_thread::yield();
+    
+    bool write_ok = true;
+    const int64_t begin = bench_util::steady_now_ns();
+    for (uint64_t i = 0; i < result.records; ++i) {
+        void* p = writer.claim(config.record_size);
+        if (p == nullptr) {
+            error = writer.error().empty() ? "追加失败" : writer.error();
+            write_ok = false;
+            break;
+        }
+        const uint64_t header[2] = {i, static_cast<uint64_t>(bench_util::steady_now_ns())};
+        std::memcpy(p, header, sizeof(header));
+        writer.commit();
+    }
+    const int64_t end = bench_util::steady_now_ns();
+    if (!write_ok) {
+        stop.store(true, std::memory_order_relaxed);
+    }
+    tailer_thread.join();
+    result.valid = write_ok && sequence_ok;
+    if (!result.valid) {
+        return result;
+    }
+    
+    const double elapsed_s = (end - begin) / 1e9;
+    result.append_mops = result.records / elapsed_s / 1e6;
+    result.append_mbps = static_cast<double>(writer.bytes_written()) / elapsed_s / (1 << 20);
+    result.catch_up_ms = std::max<int64_t>(0, tailer_done_ns.load(std::memory_order_acquire) - end) / 1e6;
+    result.files = writer.file_number() + 1;
+    result.syncs = writer.syncs();
+    std::sort(lags_us.begin(), lags_us.end());
+    result.lag_p50_us = bench_util::percentile(lags_us, 0.50);
+    result.lag_p99_us = bench_util::percentile(lags_us, 0.99);
+    result.lag_max_us = lags_us.empty() ? 0.0 : lags_us.back();
+    return result;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --dir=PATH           日志目录（默认/tmp/lfq_journal_bench，运行前后删除其中的*.journal）\n"
+              << "  --records=N          追加的记录数（默认5000000）\n"
+              << "  --always-records=N   always模式的记录数上限（默认100000）\n"
+              << "  --size=N             每条记录的字节数，至少16（默认64）\n"
+              << "  --file-mb=N          每个日志文件的大小（默认64）\n"
+              << "  --sync=LIST          同步策略列表：none,batch,always（默认全部）\n"
+              << "  --sync-interval=N    batch模式每多少条记录msync一次（默认1024）\n"
+              << "  --prefault           创建文件时预先建立页表\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    JournalBenchConfig config;
+    std::string unknown_sync;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--dir") {
+            config.directory = value;
+        } else if (key == "--records") {
+            config.records = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--always-records") {
+            config.always_records = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--size") {
+            config.record_size = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--file-mb") {
+            config.file_mb = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--sync") {
+            config.syncs.clear();
+            for (const auto& name : bench_util::split_list(value)) {
+                if (name == "none") {
+                    config.syncs.push_back(JournalSync::None);
+                } else if (name == "batch") {
+                    config.syncs.push_back(JournalSync::Batch);
+                } else if (name == "always") {
+                    config.syncs.push_back(JournalSync::Always);
+                } else {
+                    unknown_sync = name;
+                }
+            }
+        } else if (key == "--sync-interval") {
+            config.sync_interval = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--prefault") {
+            config.prefault = true;
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (!unknown_sync.empty()) {
+        std::cerr << "未知同步策略: " << unknown_sync << std::endl;
+        return 1;
+    }
+    if (config.records == 0 || config.always_records == 0 || config.record_size < 16 || config.file_mb == 0 ||
+        config.sync_interval == 0 || config.syncs.empty() ||
+        config.record_size > (config.file_mb << 20) - 128) {
+        std::cerr << "参数超出范围（记录数和同步间隔为正，记录至少16字节且小于文件大小）" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "日志队列基准（" << config.directory << "，每条" << config.record_size << "字节，文件"
+              << config.file_mb << "MB" << (config.prefault ? "，预建页表" : "") << "）" << std::endl;
+    bench_util::print_rule(100);
+    bench_util::print_header({{"同步", 8}, {"记录数", 9}, {"追加(M/s)", 13}, {"MB/s", 14}, {"滞后p50/p99/max(us)", 28},
+                              {"追上(ms)", 14}, {"文件数", 9}, {"msync次数", 0}});
+    bench_util::print_rule(100, '-');
+    
+    int exit_code = 0;
+    for (JournalSync sync : config.syncs) {
+        std::string error;
+        JournalBenchResult r = run_journal(config, sync, error);
+        if (!r.valid) {
+            std::cerr << sync_name(sync) << ": " << (error.empty() ? "读取到的记录序号或长度错误" : error) << std::endl;
+            exit_code = 1;
+            if (!error.empty()) break;
+            continue;
+        }
+        std::ostringstream lag;
+        lag << std::fixed << std::setprecision(1) << r.lag_p50_us << "/" << r.lag_p99_us << "/" << r.lag_max_us;
+        std::cout << std::setw(8) << sync_name(sync)
+                  << std::setw(9) << r.records
+                  << std::setw(13) << std::fixed << std::setprecision(2) << r.append_mops
+                  << std::setw(14) << std::setprecision(1) << r.append_mbps
+                  << std::setw(28) << lag.str()
+                  << std::setw(14) << std::setprecision(2) << r.catch_up_ms
+                  << std::setw(9) << r.files
+                  << r.syncs << std::endl;
+    }
+    bench_util::print_rule(100);
+    remove_journal_files(config.directory);
+    
+    return exit_code;
+}
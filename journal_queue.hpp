@@ -0,0 +1,608 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 持久化日志队列：写入方把记录追加到按序号滚动的内存映射文件（mmap + MAP_SHARED，
+// fallocate预分配），任意数量的读取方（tailer，可在其他进程）按序号顺序读取或从指定序号重放
+//
+// 文件格式（目录下依次为00000000.journal、00000001.journal……）：
+//   [64字节文件头：magic、版本、文件大小、本文件第一条记录的序号]
+//   [4字节长度 | 4字节保留 | 数据，补齐到8字节] ...
+//   长度为0表示尚未写入，0xFFFFFFFF表示本文件结束、继续读下一个文件
+//
+// 发布协议与SPSCLockFreeQueue相同：写入方先写数据，再用release写长度字；读取方acquire读长度字，
+// 非0即可读数据。崩溃后长度字为0的记录视为未写入，重新打开时从第一个空位置继续追加
+//
+// 崩溃前claim()写了一半的数据会留在文件中，重新追加的记录的下一个长度字可能落在这些残留字节上，
+// 所以commit()在发布长度字之前先把下一个长度字清零；读到越界的长度时按文件损坏处理
+//
+// 持久性：JournalSync::None只依赖页缓存，进程崩溃不丢数据，掉电可能丢失最近写入的记录；
+// Batch每sync_interval条记录msync一次；Always每条记录提交后msync
+enum class JournalSync {
+    None,
+    Batch,
+    Always
+};
+
+struct JournalConfig {
+    std::string directory;
+    size_t file_size = 64u << 20;  // 每个文件的大小，写满后滚动到下一个文件
+    JournalSync sync = JournalSync::None;
+    size_t sync_interval = 1024;   // Batch模式下每多少条记录同步一次
+    bool prefault = false;         // 创建文件时用MAP_POPULATE预先建立页表，避免追加时缺页
+};
+
+namespace journal_detail {
+
+constexpr uint64_t kMagic = 0x314C4E524A51464CULL;  // "LFQJRNL1"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kFileHeaderSize = 64;
+constexpr size_t kRecordHeaderSize = 8;
+constexpr uint32_t kEndOfFile = 0xFFFFFFFFu;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == 4,
+              "journal length words require lock-free 32-bit atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && sizeof(std::atomic<uint64_t>) == 8,
+              "journal file header requires lock-free 64-bit atomics");
+
+struct FileHeader {
+    std::atomic<uint64_t> magic;  // 最后写入，读取方看到magic后文件头其余字段有效
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t file_size;
+    uint64_t first_index;
+};
+static_assert(sizeof(FileHeader) <= kFileHeaderSize, "file header too large");
+
+inline size_t align8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+inline std::string file_path(const std::string& directory, uint64_t number) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08llu.journal", static_cast<unsigned long long>(number));
+    return directory + "/" + name;
+}
+
+inline std::atomic<uint32_t>* length_word(unsigned char* base, size_t offset) {
+    return reinterpret_cast<std::atomic<uint32_t>*>(base + offset);
+}
+
+// 偏移pos处长度为length的记录放得下，且之后还留有写结束标记的位置
+inline bool record_fits(size_t pos, size_t length, size_t file_size) {
+    return pos + kRecordHeaderSize + align8(length) <= file_size - kRecordHeaderSize;
+}
+
+inline bool file_exists(const std::string& path) {
+#ifdef __linux__
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// 一个映射到内存的日志文件
+class MappedFile {
+private:
+    unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+
+public:
+    MappedFile() = default;
+    
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          fd_(std::exchange(other.fd_, -1)) {}
+    
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+    
+    ~MappedFile() {
+        close();
+    }
+    
+    // 禁止拷贝
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    // 创建（或截断）文件，预分配size字节后以读写方式映射
+    bool create(const std::string& path, size_t size, bool prefault, std::string& error) {
+#ifdef __linux__
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            error = "创建" + path + "失败: " + strerror(errno);
+            return false;
+        }
+        // 文件系统不支持fallocate时退回ftruncate（稀疏文件，首次写入时才分配磁盘块）
+        if (::fallocate(fd_, 0, 0, static_cast<off_t>(size)) != 0 &&
+            ::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            error = "预分配" + path + "失败: " + strerror(errno);
+            close();
+            return false;
+        }
+        return map(path, size, PROT_READ | PROT_WRITE, prefault ? MAP_POPULATE : 0, error);
+#else
+        (void)path;
+        (void)size;
+        (void)prefault;
+        error = "当前平台不支持日志队列";
+        return false;
+#endif
+    }
+    
+    // 打开已有文件；文件不存在时返回false且不设置error
+    bool open_existing(const std::string& path, bool writable, std::string& error) {
+#ifdef __linux__
+        close();
+        fd_ = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+        if (fd_ < 0) {
+            if (errno != ENOENT) {
+                error = "打开" + path + "失败: " + strerror(errno);
+            }
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < kFileHeaderSize + 2 * kRecordHeaderSize) {
+            error = path + "不是有效的日志文件";
+            close();
+            return false;
+        }
+        return map(path, static_cast<size_t>(st.st_size), writable ? PROT_READ | PROT_WRITE : PROT_READ, 0, error);
+#else
+        (void)path;
+        (void)writable;
+        error = "当前平台不支持日志队列";
+        return false;
+#endif
+    }
+    
+    void close() {
+#ifdef __linux__
+        if (data_ != nullptr) ::munmap(data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        fd_ = -1;
+    }
+    
+    // 把[begin, end)所在的页同步到磁盘
+    bool sync(size_t begin, size_t end) {
+#ifdef __linux__
+        if (data_ == nullptr || end <= begin) return true;
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t aligned = begin & ~(page - 1);
+        return ::msync(data_ + aligned, end - aligned, MS_SYNC) == 0;
+#else
+        (void)begin;
+        (void)end;
+        return false;
+#endif
+    }
+    
+    unsigned char* data() const {
+        return data_;
+    }
+    
+    size_t size() const {
+        return size_;
+    }
+    
+    FileHeader* header() const {
+        return reinterpret_cast<FileHeader*>(data_);
+    }
+
+private:
+#ifdef __linux__
+    bool map(const std::string& path, size_t size, int prot, int extra_flags, std::string& error) {
+        void* p = ::mmap(nullptr, size, prot, MAP_SHARED | extra_flags, fd_, 0);
+        if (p == MAP_FAILED) {
+            error = "映射" + path + "失败: " + strerror(errno);
+            close();
+            return false;
+        }
+        data_ = static_cast<unsigned char*>(p);
+        size_ = size;
+        return true;
+    }
+#endif
+};
+
+}  // namespace journal_detail
+
+// 写入方：同一目录只能有一个写入方
+//
+//   JournalWriter writer({"/data/gateway"});
+//   if (void* p = writer.claim(sizeof(Order))) {   // 直接在映射区构造记录，不额外拷贝
+//       new (p) Order{...};
+//       writer.commit();
+//   }
+//
+// 打开已有目录时从最后一个文件的第一个空位置继续追加（崩溃恢复）
+class JournalWriter {
+private:
+    JournalConfig config_;
+    std::string error_;
+    journal_detail::MappedFile file_;
+    uint64_t file_number_ = 0;
+    size_t pos_ = 0;               // 下一条记录在当前文件中的偏移
+    uint64_t next_index_ = 0;      // 下一条记录的序号
+    uint32_t pending_size_ = 0;    // claim()后尚未commit的记录长度
+    size_t sync_from_ = 0;         // 当前文件中尚未同步的起始偏移
+    size_t unsynced_records_ = 0;
+    uint64_t bytes_written_ = 0;
+    uint64_t syncs_ = 0;
+    
+    bool create_file(uint64_t number, uint64_t first_index) {
+        using namespace journal_detail;
+        MappedFile next;
+        if (!next.create(file_path(config_.directory, number), config_.file_size, config_.prefault, error_)) {
+            return false;
+        }
+        FileHeader* header = next.header();
+        header->version = kVersion;
+        header->header_size = static_cast<uint32_t>(kFileHeaderSize);
+        header->file_size = config_.file_size;
+        header->first_index = first_index;
+        header->magic.store(kMagic, std::memory_order_release);
+        
+        file_ = std::move(next);
+        file_number_ = number;
+        pos_ = kFileHeaderSize;
+        next_index_ = first_index;
+        sync_from_ = 0;
+        return true;
+    }
+    
+    // 找到最后一个文件并扫描到第一个空位置
+    bool recover() {
+        using namespace journal_detail;
+        if (!file_exists(file_path(config_.directory, 0))) {
+            return create_file(0, 0);
+        }
+        uint64_t last = 0;
+        while (file_exists(file_path(config_.directory, last + 1))) ++last;
+        
+        // 创建到一半就崩溃的文件（magic未写入）直接丢弃，回到上一个文件
+        while (true) {
+            MappedFile existing;
+            if (!existing.open_existing(file_path(config_.directory, last), true, error_)) {
+                if (error_.empty()) error_ = file_path(config_.directory, last) + "在恢复过程中消失";
+                return false;
+            }
+            if (existing.header()->magic.load(std::memory_order_acquire) == kMagic) {
+                file_ = std::move(existing);
+                break;
+            }
+            existing.close();
+#ifdef __linux__
+            ::unlink(file_path(config_.directory, last).c_str());
+#endif
+            if (last == 0) return create_file(0, 0);
+            --last;
+        }
+        
+        file_number_ = last;
+        next_index_ = file_.header()->first_index;
+        pos_ = kFileHeaderSize;
+        while (true) {
+            const uint32_t length = length_word(file_.data(), pos_)->load(std::memory_order_acquire);
+            if (length == 0) break;
+            if (length == kEndOfFile) {
+                return create_file(file_number_ + 1, next_index_);  // 结束标记已写但下一个文件未创建
+            }
+            if (!record_fits(pos_, length, file_.size())) {
+                error_ = file_path(config_.directory, last) + "中的记录长度损坏";
+                return false;
+            }
+            pos_ += kRecordHeaderSize + align8(length);
+            ++next_index_;
+        }
+        sync_from_ = pos_;
+        return true;
+    }
+    
+    // 写结束标记后切换到下一个文件
+    bool roll() {
+        using namespace journal_detail;
+        length_word(file_.data(), pos_)->store(kEndOfFile, std::memory_order_release);
+        if (config_.sync != JournalSync::None) {
+            file_.sync(sync_from_, pos_ + kRecordHeaderSize);
+            ++syncs_;
+        }
+        return create_file(file_number_ + 1, next_index_);
+    }
+
+public:
+    explicit JournalWriter(JournalConfig config) : config_(std::move(config)) {
+#ifdef __linux__
+        config_.file_size = journal_detail::align8(config_.file_size);
+        if (config_.file_size < 4096) {
+            error_ = "日志文件大小至少为4096字节";
+            return;
+        }
+        if (::mkdir(config_.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            error_ = "创建目录" + config_.directory + "失败: " + strerror(errno);
+            return;
+        }
+        if (!recover()) {
+            file_.close();
+        }
+#else
+        error_ = "当前平台不支持日志队列";
+#endif
+    }
+    
+    ~JournalWriter() {
+        if (config_.sync != JournalSync::None) {
+            sync();
+        }
+    }
+    
+    // 禁止拷贝和移动
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+    JournalWriter(JournalWriter&&) = delete;
+    JournalWriter& operator=(JournalWriter&&) = delete;
+    
+    bool available() const {
+        return file_.data() != nullptr;
+    }
+    
+    const std::string& error() const {
+        return error_;
+    }
+    
+    // 单条记录的最大长度（一个文件除去文件头、记录头和结束标记后的空间）
+    size_t max_record_size() const {
+        using namespace journal_detail;
+        return config_.file_size - kFileHeaderSize - 2 * kRecordHeaderSize;
+    }
+    
+    // 在映射区中预留size字节（1 <= size <= max_record_size()），返回写入位置；
+    // 写完后调用commit()发布。当前文件放不下时先滚动到下一个文件
+    void* claim(uint32_t size) {
+        using namespace journal_detail;
+        if (!available() || size == 0 || size > max_record_size()) {
+            return nullptr;
+        }
+        if (!record_fits(pos_, size, file_.size()) && !roll()) {
+            file_.close();
+            return nullptr;
+        }
+        pending_size_ = size;
+        return file_.data() + pos_ + kRecordHeaderSize;
+    }
+    
+    // 发布claim()预留的记录，之后读取方可见
+    void commit() {
+        using namespace journal_detail;
+        const size_t next = pos_ + kRecordHeaderSize + align8(pending_size_);
+        // 下一个长度字可能是崩溃前残留的数据，先清零再发布，读取方看到本记录时下一条必为未写入
+        length_word(file_.data(), next)->store(0, std::memory_order_relaxed);
+        length_word(file_.data(), pos_)->store(pending_size_, std::memory_order_release);
+        pos_ = next;
+        bytes_written_ += pending_size_;
+        ++next_index_;
+        
+        if (config_.sync == JournalSync::Always ||
+            (config_.sync == JournalSync::Batch && ++unsynced_records_ >= config_.sync_interval)) {
+            sync();
+        }
+    }
+    
+    // 拷贝一条记录到日志中
+    bool append(const void* data, uint32_t size) {
+        void* p = claim(size);
+        if (p == nullptr) {
+            return false;
+        }
+        std::memcpy(p, data, size);
+        commit();
+        return true;
+    }
+    
+    template<typename T>
+    bool append(const T& record) {
+        static_assert(std::is_trivially_copyable<T>::value, "journal records must be trivially copyable");
+        return append(&record, static_cast<uint32_t>(sizeof(T)));
+    }
+    
+    // 把尚未同步的记录写到磁盘
+    bool sync() {
+        if (!available()) return false;
+        const bool ok = file_.sync(sync_from_, pos_);
+        sync_from_ = pos_;
+        unsynced_records_ = 0;
+        ++syncs_;
+        return ok;
+    }
+    
+    // 下一条记录的序号（即已写入的记录总数）
+    uint64_t next_index() const {
+        return next_index_;
+    }
+    
+    uint64_t file_number() const {
+        return file_number_;
+    }
+    
+    uint64_t bytes_written() const {
+        return bytes_written_;
+    }
+    
+    uint64_t syncs() const {
+        return syncs_;
+    }
+};
+
+// 读取方：按序号顺序读取，可以与写入方在不同进程；多个读取方互不影响
+//
+//   JournalTailer tailer("/data/gateway", start_index);
+//   const void* data; uint32_t size;
+//   while (tailer.read(data, size)) process(data, size);   // data指向映射区，不拷贝
+class JournalTailer {
+private:
+    std::string directory_;
+    std::string error_;
+    journal_detail::MappedFile file_;
+    uint64_t file_number_ = 0;
+    size_t pos_ = 0;
+    uint64_t index_ = 0;
+    
+    // 打开第number个文件；文件不存在或尚未初始化完成时返回false
+    bool open_file(uint64_t number) {
+        using namespace journal_detail;
+        MappedFile next;
+        if (!next.open_existing(file_path(directory_, number), false, error_)) {
+            return false;
+        }
+        if (next.header()->magic.load(std::memory_order_acquire) != kMagic) {
+            return false;
+        }
+        file_ = std::move(next);
+        file_number_ = number;
+        pos_ = kFileHeaderSize;
+        index_ = file_.header()->first_index;
+        return true;
+    }
+    
+    // 当前位置的记录长度；0表示尚未写入
+    uint32_t peek_length() const {
+        return journal_detail::length_word(file_.data(), pos_)->load(std::memory_order_acquire);
+    }
+    
+    // 长度越界说明文件已损坏，记录错误后停在当前位置
+    bool check_length(uint32_t length) {
+        using namespace journal_detail;
+        if (record_fits(pos_, length, file_.size())) {
+            return true;
+        }
+        error_ = file_path(directory_, file_number_) + "中的记录长度损坏";
+        return false;
+    }
+
+public:
+    explicit JournalTailer(std::string directory, uint64_t start_index = 0) : directory_(std::move(directory)) {
+        if (open_file(0) && start_index > 0) {
+            seek(start_index);
+        }
+    }
+    
+    // 禁止拷贝和移动
+    JournalTailer(const JournalTailer&) = delete;
+    JournalTailer& operator=(const JournalTailer&) = delete;
+    JournalTailer(JournalTailer&&) = delete;
+    JournalTailer& operator=(JournalTailer&&) = delete;
+    
+    // 第一个文件已打开；写入方尚未创建目录时为false，read()会继续尝试
+    bool available() const {
+        return file_.data() != nullptr;
+    }
+    
+    const std::string& error() const {
+        return error_;
+    }
+    
+    // 读取下一条记录；没有新记录或记录长度损坏（error()非空）时返回false
+    // data指向映射区，在下一次read()/seek()之前有效
+    bool read(const void*& data, uint32_t& size) {
+        using namespace journal_detail;
+        if (!available() && !open_file(0)) {
+            return false;
+        }
+        while (true) {
+            const uint32_t length = peek_length();
+            if (length == 0) {
+                return false;
+            }
+            if (length == kEndOfFile) {
+                if (!open_file(file_number_ + 1)) return false;  // 下一个文件还未创建，稍后重试
+                continue;
+            }
+            if (!check_length(length)) {
+                return false;
+            }
+            data = file_.data() + pos_ + kRecordHeaderSize;
+            size = length;
+            pos_ += kRecordHeaderSize + align8(length);
+            ++index_;
+            return true;
+        }
+    }
+    
+    // 读取一条定长记录并拷贝出来；长度不符时跳过该记录并返回false
+    template<typename T>
+    bool read(T& record) {
+        static_assert(std::is_trivially_copyable<T>::value, "journal records must be trivially copyable");
+        const void* data = nullptr;
+        uint32_t size = 0;
+        if (!read(data, size) || size != sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&record, data, sizeof(T));
+        return true;
+    }
+    
+    // 定位到序号为index的记录：先按文件头跳到所在文件，再在文件内逐条跳过
+    // 该记录尚未写入时停在已写入的末尾并返回false；记录长度损坏时同样返回false，error()非空
+    bool seek(uint64_t index) {
+        using namespace journal_detail;
+        if (!open_file(0)) {
+            return false;
+        }
+        while (true) {
+            MappedFile next;
+            std::string ignored;
+            if (!next.open_existing(file_path(directory_, file_number_ + 1), false, ignored) ||
+                next.header()->magic.load(std::memory_order_acquire) != kMagic ||
+                next.header()->first_index > index) {
+                break;
+            }
+            open_file(file_number_ + 1);
+        }
+        while (index_ < index) {
+            const uint32_t length = peek_length();
+            if (length == 0 || length == kEndOfFile || !check_length(length)) {
+                return false;
+            }
+            pos_ += kRecordHeaderSize + align8(length);
+            ++index_;
+        }
+        return true;
+    }
+    
+    // 下一条要读取的记录的序号
+    uint64_t index() const {
+        return index_;
+    }
+    
+    uint64_t file_number() const {
+        return file_number_;
+    }
+};
@@ -13,6 +13,8 @@ private:
     size_t max_size_;
     
 public:
+    using value_type = T;
+    
     explicit LockedQueue(size_t max_size = 1024) : max_size_(max_size) {}
     
     // 禁止拷贝和移动
@@ -48,6 +50,35 @@ public:
         return true;
     }
     
+    // 批量入队，整批只加一次锁，返回实际入队数量
+    size_t enqueue_bulk(const T* items, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        size_t n = 0;
+        while (n < count && queue_.size() < max_size_) {
+            queue_.push(items[n++]);
+        }
+        
+        if (n == 1) {
+            condition_.notify_one();
+        } else if (n > 1) {
+            condition_.notify_all();
+        }
+        return n;
+    }
+    
+    // 批量出队（非阻塞），返回实际出队数量
+    size_t dequeue_bulk(T* items, size_t max_count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        size_t n = 0;
+        while (n < max_count && !queue_.empty()) {
+            items[n++] = std::move(queue_.front());
+            queue_.pop();
+        }
+        return n;
+    }
+    
     // 阻塞式出队操作
     void dequeue_blocking(T& item) {
         std::unique_lock<std::mutex> lock(mutex_);
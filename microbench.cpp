@@ -0,0 +1,365 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <iomanip>
+#include <functional>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "spsc_lockfree_queue.hpp"
+#include "locked_queue.hpp"
+#include "double_buffer_spsc.hpp"
+#include "queue_tracer.hpp"
+#include "inplace_task.hpp"
+#include "bench_util.hpp"
+
+// 单线程微基准：在无竞争条件下测量单个操作的开销
+// 与benchmark的双线程吞吐量测试互补，便于单独评估热路径上的小改动
+
+// 64字节测试消息
+struct Message64 {
+    uint64_t id;
+    char padding[56];
+};
+
+// 每个微基准接收迭代次数，在内部循环执行被测操作
+struct MicroBenchmark {
+    std::string name;
+    std::function<void(size_t)> run;
+};
+
+struct MicroResult {
+    std::string name;
+    size_t iterations = 0;
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+    double mean_ns = 0.0;
+    double stddev_ns = 0.0;
+};
+
+double time_batch_ns(const MicroBenchmark& bench, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    bench.run(iterations);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// 先把迭代次数放大到单批耗时不少于min_time_ns，再重复测量取统计量
+MicroResult measure(const MicroBenchmark& bench, double min_time_ns, int repetitions) {
+    size_t iterations = 1;
+    while (true) {
+        double elapsed = time_batch_ns(bench, iterations);
+        if (elapsed >= min_time_ns || iterations >= (size_t(1) << 34)) break;
+        // 按已测耗时估算，最多放大10倍避免一次跳得太远
+        double factor = elapsed > 0.0 ? min_time_ns * 1.2 / elapsed : 10.0;
+        iterations = static_cast<size_t>(iterations * std::min(std::max(factor, 2.0), 10.0));
+    }
+    
+    std::vector<double> per_op;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        per_op.push_back(time_batch_ns(bench, iterations) / iterations);
+    }
+    std::sort(per_op.begin(), per_op.end());
+    
+    MicroResult result;
+    result.name = bench.name;
+    result.iterations = iterations;
+    result.min_ns = per_op.front();
+    result.median_ns = bench_util::median(per_op);
+    double sum = 0.0;
+    for (double v : per_op) sum += v;
+    result.mean_ns = sum / per_op.size();
+    double var = 0.0;
+    for (double v : per_op) var += (v - result.mean_ns) * (v - result.mean_ns);
+    result.stddev_ns = per_op.size() > 1 ? std::sqrt(var / (per_op.size() - 1)) : 0.0;
+    return result;
+}
+
+// 注册全部微基准，队列对象在run外创建，只计被测操作本身
+std::vector<MicroBenchmark> make_benchmarks() {
+    std::vector<MicroBenchmark> benches;
+    
+    // SPSC无锁队列
+    auto spsc_u64 = std::make_shared<SPSCLockFreeQueue<uint64_t, 1024>>();
+    benches.push_back({"spsc/enqueue+dequeue/u64", [spsc_u64](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            spsc_u64->enqueue(i);
+            spsc_u64->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    
+    auto spsc_msg = std::make_shared<SPSCLockFreeQueue<Message64, 1024>>();
+    benches.push_back({"spsc/enqueue+dequeue/64B", [spsc_msg](size_t n) {
+        Message64 in{};
+        Message64 out{};
+        for (size_t i = 0; i < n; ++i) {
+            in.id = i;
+            spsc_msg->enqueue(in);
+            spsc_msg->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    
+    // 先写满一批再读空，摊薄到每个元素，反映积压时的逐元素开销
+    benches.push_back({"spsc/burst64/u64", [spsc_u64](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; i += 64) {
+            for (size_t j = 0; j < 64; ++j) spsc_u64->enqueue(j);
+            for (size_t j = 0; j < 64; ++j) spsc_u64->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    
+    // 同样一批64个，走批量接口时整批只读写一次对方索引
+    benches.push_back({"spsc/bulk64/u64", [spsc_u64](size_t n) {
+        uint64_t in[64];
+        uint64_t out[64];
+        for (size_t j = 0; j < 64; ++j) in[j] = j;
+        for (size_t i = 0; i < n; i += 64) {
+            spsc_u64->enqueue_bulk(in, 64);
+            spsc_u64->dequeue_bulk(out, 64);
+            bench_util::do_not_optimize(out[63]);
+        }
+    }});
+    
+    // 开启统计策略后的同一组操作，与上面两项对比即为统计开销
+    auto spsc_stats = std::make_shared<SPSCLockFreeQueue<uint64_t, 1024, SPSCQueueStats>>();
+    benches.push_back({"spsc_stats/enqueue+dequeue/u64", [spsc_stats](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            spsc_stats->enqueue(i);
+            spsc_stats->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    benches.push_back({"spsc_stats/burst64/u64", [spsc_stats](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; i += 64) {
+            for (size_t j = 0; j < 64; ++j) spsc_stats->enqueue(j);
+            for (size_t j = 0; j < 64; ++j) spsc_stats->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    benches.push_back({"spsc_stats/snapshot", [spsc_stats](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            SPSCQueueStatsSnapshot stats = spsc_stats->snapshot();
+            bench_util::do_not_optimize(stats);
+        }
+    }});
+    
+    // 1/1024采样跟踪，绝大多数操作只走未采样的分支；跟踪文件写到/dev/null
+    auto tracer = std::make_shared<QueueTracer>("/dev/null");
+    auto spsc_traced = std::make_shared<TracedQueue<SPSCLockFreeQueue<uint64_t, 1024>>>(*tracer, "spsc", 1024);
+    tracer->start();
+    benches.push_back({"spsc_traced/enqueue+dequeue/u64", [tracer, spsc_traced](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            spsc_traced->enqueue(i);
+            spsc_traced->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    
+    // 观测接口在半满队列上测量
+    auto spsc_half = std::make_shared<SPSCLockFreeQueue<uint64_t, 1024>>();
+    for (uint64_t i = 0; i < 512; ++i) spsc_half->enqueue(i);
+    benches.push_back({"spsc/size", [spsc_half](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t size = spsc_half->size();
+            bench_util::do_not_optimize(size);
+            bench_util::clobber_memory();
+        }
+    }});
+    benches.push_back({"spsc/empty", [spsc_half](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            bool empty = spsc_half->empty();
+            bench_util::do_not_optimize(empty);
+            bench_util::clobber_memory();
+        }
+    }});
+    benches.push_back({"spsc/full", [spsc_half](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            bool full = spsc_half->full();
+            bench_util::do_not_optimize(full);
+            bench_util::clobber_memory();
+        }
+    }});
+    
+    // 双缓冲SPSC
+    auto db_u64 = std::make_shared<DoubleBufferSPSC<uint64_t>>(1024);
+    benches.push_back({"double_buffer/swap_buffers", [db_u64](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            db_u64->swap_buffers();
+            bench_util::clobber_memory();
+        }
+    }});
+    benches.push_back({"double_buffer/enqueue+swap+dequeue/u64", [db_u64](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            db_u64->enqueue(i);
+            db_u64->swap_buffers();
+            db_u64->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    benches.push_back({"double_buffer/burst64/u64", [db_u64](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; i += 64) {
+            for (size_t j = 0; j < 64; ++j) db_u64->enqueue(j);
+            db_u64->swap_buffers();
+            for (size_t j = 0; j < 64; ++j) db_u64->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    benches.push_back({"double_buffer/has_data", [db_u64](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            bool has_data = db_u64->has_data();
+            bench_util::do_not_optimize(has_data);
+            bench_util::clobber_memory();
+        }
+    }});
+    
+    // 任务作为槽位类型：入队一个lambda、出队并调用
+    // 8字节捕获两者都不分配内存；24字节捕获超过libstdc++中std::function的16字节内联存储，每次入队都要堆分配
+    auto task_inplace = std::make_shared<SPSCLockFreeQueue<InplaceTask<48>, 1024>>();
+    auto task_function = std::make_shared<SPSCLockFreeQueue<std::function<void()>, 1024>>();
+    benches.push_back({"task/inplace/enqueue+invoke/8B", [task_inplace](size_t n) {
+        uint64_t counter = 0;
+        uint64_t* target = &counter;
+        InplaceTask<48> out;
+        for (size_t i = 0; i < n; ++i) {
+            task_inplace->enqueue([target]() { ++*target; });
+            task_inplace->dequeue(out);
+            out();
+        }
+        bench_util::do_not_optimize(counter);
+    }});
+    benches.push_back({"task/function/enqueue+invoke/8B", [task_function](size_t n) {
+        uint64_t counter = 0;
+        uint64_t* target = &counter;
+        std::function<void()> out;
+        for (size_t i = 0; i < n; ++i) {
+            task_function->enqueue([target]() { ++*target; });
+            task_function->dequeue(out);
+            out();
+        }
+        bench_util::do_not_optimize(counter);
+    }});
+    benches.push_back({"task/inplace/enqueue+invoke/24B", [task_inplace](size_t n) {
+        uint64_t counter = 0;
+        uint64_t* target = &counter;
+        InplaceTask<48> out;
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t a = i;
+            const uint64_t b = i >> 1;
+            task_inplace->enqueue([target, a, b]() { *target += a ^ b; });
+            task_inplace->dequeue(out);
+            out();
+        }
+        bench_util::do_not_optimize(counter);
+    }});
+    benches.push_back({"task/function/enqueue+invoke/24B", [task_function](size_t n) {
+        uint64_t counter = 0;
+        uint64_t* target = &counter;
+        std::function<void()> out;
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t a = i;
+            const uint64_t b = i >> 1;
+            task_function->enqueue([target, a, b]() { *target += a ^ b; });
+            task_function->dequeue(out);
+            out();
+        }
+        bench_util::do_not_optimize(counter);
+    }});
+    
+    // 有锁队列作为参照
+    auto locked_u64 = std::make_shared<LockedQueue<uint64_t>>(1024);
+    benches.push_back({"locked/enqueue+dequeue/u64", [locked_u64](size_t n) {
+        uint64_t out = 0;
+        for (size_t i = 0; i < n; ++i) {
+            locked_u64->enqueue(i);
+            locked_u64->dequeue(out);
+            bench_util::do_not_optimize(out);
+        }
+    }});
+    benches.push_back({"locked/bulk64/u64", [locked_u64](size_t n) {
+        uint64_t in[64];
+        uint64_t out[64];
+        for (size_t j = 0; j < 64; ++j) in[j] = j;
+        for (size_t i = 0; i < n; i += 64) {
+            locked_u64->enqueue_bulk(in, 64);
+            locked_u64->dequeue_bulk(out, 64);
+            bench_util::do_not_optimize(out[63]);
+        }
+    }});
+    benches.push_back({"locked/size", [locked_u64](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t size = locked_u64->size();
+            bench_util::do_not_optimize(size);
+        }
+    }});
+    
+    return benches;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --filter=STR         只运行名称包含STR的微基准\n"
+              << "  --repetitions=N      每个微基准重复测量次数（默认15）\n"
+              << "  --min-time-ms=N      单次测量的最短时间（默认20）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    int repetitions = 15;
+    double min_time_ms = 20.0;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--filter") {
+            filter = value;
+        } else if (key == "--repetitions") {
+            repetitions = std::atoi(value.c_str());
+        } else if (key == "--min-time-ms") {
+            min_time_ms = std::atof(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (repetitions <= 0 || min_time_ms <= 0.0) {
+        std::cerr << "重复次数和最短时间必须为正" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "单线程微基准（重复 " << repetitions << " 次，每次至少 " << min_time_ms << "ms）" << std::endl;
+    bench_util::print_rule(100);
+    bench_util::print_header({{"名称", 44}, {"迭代次数", 14}, {"中位数(ns)", 12}, {"最小(ns)", 12}, {"标准差(ns)", 12}, {"CV", 0}});
+    bench_util::print_rule(100, '-');
+    
+    for (const auto& bench : make_benchmarks()) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+        
+        MicroResult r = measure(bench, min_time_ms * 1e6, repetitions);
+        std::cout << std::setw(44) << r.name
+                  << std::setw(14) << r.iterations
+                  << std::setw(12) << std::fixed << std::setprecision(2) << r.median_ns
+                  << std::setw(12) << r.min_ns
+                  << std::setw(12) << r.stddev_ns
+                  << std::setprecision(1) << (r.mean_ns > 0.0 ? 100.0 * r.stddev_ns / r.mean_ns : 0.0) << "%"
+                  << std::endl;
+    }
+    bench_util::print_rule(100);
+    
+    return 0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// 有界多生产者多消费者队列（Dmitry Vyukov的序号环）
+// 每个槽位带一个序号：生产者在序号等于入队位置时认领槽位，写入后把序号加1发布；
+// 消费者在序号等于出队位置+1时认领槽位，读出后把序号推进一整圈交还给生产者。
+// 只有一个生产者或消费者的一侧不需要CAS，由模板参数关闭
+template<typename T, bool MultiProducer = true, bool MultiConsumer = true>
+class MPMCBoundedQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+    
+    // 构造后只读，两端共享
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};  // 避免false sharing
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};  // 避免false sharing
+
+public:
+    using value_type = T;
+    
+    // 容量向上取整到2的幂次
+    explicit MPMCBoundedQueue(size_t capacity = 1024) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells_.reset(new Cell[size]);
+        mask_ = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    // 禁止拷贝和移动
+    MPMCBoundedQueue(const MPMCBoundedQueue&) = delete;
+    MPMCBoundedQueue& operator=(const MPMCBoundedQueue&) = delete;
+    MPMCBoundedQueue(MPMCBoundedQueue&&) = delete;
+    MPMCBoundedQueue& operator=(MPMCBoundedQueue&&) = delete;
+    
+    // 生产者端：入队操作
+    template<typename U>
+    bool enqueue(U&& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            
+            if (diff == 0) {
+                // 槽位空闲，认领该位置
+                if (!MultiProducer) {
+                    enqueue_pos_.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列已满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);  // 被其他生产者抢先
+            }
+        }
+        
+        // 存储数据并发布
+        cell->data = std::forward<U>(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // 消费者端：出队操作
+    bool dequeue(T& item) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            
+            if (diff == 0) {
+                // 槽位已发布，认领该位置
+                if (!MultiConsumer) {
+                    dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列为空
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);  // 被其他消费者抢先
+            }
+        }
+        
+        // 读取数据并把槽位交还给下一圈的生产者
+        item = std::move(cell->data);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // 检查队列是否为空（近似值）
+    bool empty() const {
+        return size() == 0;
+    }
+    
+    // 获取当前队列大小（近似值）
+    size_t size() const {
+        const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    
+    // 获取队列容量
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+};
@@ -0,0 +1,223 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "overwrite_ring.hpp"
+#include "spsc_lockfree_queue.hpp"
+#include "bench_util.hpp"
+
+// 覆盖环基准：OverwriteRing与SPSCLockFreeQueue对比
+//   solo      单线程，每次入队32条再出队32条，测每条的入队+出队开销
+//   produce   单线程只入队（OverwriteRing不需要消费者），测生产者本身的开销
+//   threaded  生产者全速写入，消费者每条耗时work-ns；普通环满时生产者等待，覆盖环直接覆盖。
+//             消费者校验每条元素没有被撕裂、序号差与报告的丢失数一致，结束时收到数+丢失数=写入数
+
+constexpr size_t kRingSize = 4096;
+constexpr size_t kPayloadWords = 8;  // 64字节元素
+
+// 每个字都由序号导出，读到不一致的字说明元素被撕裂
+struct Sample {
+    uint64_t words[kPayloadWords];
+    
+    static Sample make(uint64_t sequence) {
+        Sample s;
+        for (size_t i = 0; i < kPayloadWords; ++i) {
+            s.words[i] = sequence ^ (0x9e3779b97f4a7c15ull * i);
+        }
+        return s;
+    }
+    
+    bool consistent() const {
+        for (size_t i = 1; i < kPayloadWords; ++i) {
+            if (words[i] != (words[0] ^ (0x9e3779b97f4a7c15ull * i))) return false;
+        }
+        return true;
+    }
+};
+
+using Ring = OverwriteRing<Sample, kRingSize>;
+using Plain = SPSCLockFreeQueue<Sample, kRingSize>;
+
+struct OverwriteBenchConfig {
+    size_t items = 10000000;
+    std::vector<int> work_ns{0, 100};
+    int repetitions = 3;
+};
+
+struct ThreadedResult {
+    double producer_ns = 0.0;   // 生产者每条耗时（含普通环满时的等待）
+    size_t received = 0;
+    size_t lost = 0;
+    size_t full_waits = 0;
+    bool valid = true;
+};
+
+inline bool pop(Ring& ring, Sample& s, size_t& lost) {
+    return ring.dequeue(s, lost);
+}
+
+inline bool pop(Plain& queue, Sample& s, size_t& lost) {
+    lost = 0;
+    return queue.dequeue(s);
+}
+
+template<typename Queue>
+double run_solo(const OverwriteBenchConfig& config) {
+    auto queue = std::make_unique<Queue>();
+    double best = 0.0;
+    uint64_t sink = 0;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        const int64_t begin = bench_util::steady_now_ns();
+        Sample s{};
+        for (uint64_t i = 0; i < config.items; i += 32) {
+            for (uint64_t j = 0; j < 32; ++j) {
+                queue->enqueue(Sample::make(i + j));
+            }
+            for (uint64_t j = 0; j < 32; ++j) {
+                queue->dequeue(s);
+                sink += s.words[0];
+            }
+        }
+        const double ns = static_cast<double>(bench_util::steady_now_ns() - begin) / config.items;
+        best = rep == 0 ? ns : std::min(best, ns);
+    }
+    bench_util::do_not_optimize(sink);  // 防止出队被优化掉
+    return best;
+}
+
+double run_produce(const OverwriteBenchConfig& config) {
+    auto ring = std::make_unique<Ring>();
+    double best = 0.0;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        const int64_t begin = bench_util::steady_now_ns();
+        for (uint64_t i = 0; i < config.items; ++i) {
+            ring->enqueue(Sample::make(i));
+        }
+        const double ns = static_cast<double>(bench_util::steady_now_ns() - begin) / config.items;
+        best = rep == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+template<typename Queue>
+ThreadedResult run_threaded(const OverwriteBenchConfig& config, int work_ns) {
+    auto queue = std::make_unique<Queue>();
+    ThreadedResult result;
+    std::atomic<bool> done{false};
+    
+    std::thread consumer([&]() {
+        Sample s;
+        size_t lost = 0;
+        uint64_t expected = 0;
+        while (true) {
+            const bool finished = done.load(std::memory_order_acquire);
+            if (!pop(*queue, s, lost)) {
+                if (finished) break;
+                std::this_thread::yield();
+                continue;
+            }
+            if (!s.consistent() || s.words[0] != expected + lost) {
+                result.valid = false;
+            }
+            expected = s.words[0] + 1;
+            result.lost += lost;
+            ++result.received;
+            bench_util::busy_work(work_ns);
+        }
+    });
+    
+    const int64_t begin = bench_util::steady_now_ns();
+    for (uint64_t i = 0; i < config.items; ++i) {
+        while (!queue->enqueue(Sample::make(i))) {
+            ++result.full_waits;
+            std::this_thread::yield();
+        }
+    }
+    result.producer_ns = static_cast<double>(bench_util::steady_now_ns() - begin) / config.items;
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    
+    if (result.received + result.lost != config.items) {
+        result.valid = false;
+    }
+    return result;
+}
+
+void print_row(const char* name, const std::string& mode, double ns, size_t received, size_t lost,
+               size_t full_waits, const char* check) {
+    std::cout << std::setw(12) << name
+              << std::setw(16) << mode
+              << std::setw(14) << std::fixed << std::setprecision(2) << ns
+              << std::setw(12) << received
+              << std::setw(12) << lost
+              << std::setw(12) << full_waits
+              << check << std::endl;
+}
+
+template<typename Queue>
+bool report_threaded(const char* name, const OverwriteBenchConfig& config, int work_ns) {
+    ThreadedResult r = run_threaded<Queue>(config, work_ns);
+    print_row(name, "threaded/" + std::to_string(work_ns) + "ns", r.producer_ns, r.received, r.lost, r.full_waits,
+              r.valid ? "通过" : "失败");
+    return r.valid;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --items=N            每项写入的元素数（默认10000000）\n"
+              << "  --work-ns=LIST       threaded测试中消费者每条的耗时列表（默认0,100）\n"
+              << "  --repetitions=N      单线程测试重复次数，取最好的一次（默认3）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    OverwriteBenchConfig config;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--items") {
+            config.items = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--work-ns") {
+            config.work_ns = bench_util::parse_int_list(value);
+        } else if (key == "--repetitions") {
+            config.repetitions = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (config.items == 0 || config.repetitions <= 0) {
+        std::cerr << "参数超出范围（元素数和重复次数为正）" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "覆盖环基准（环大小" << kRingSize << "，元素" << sizeof(Sample) << "字节，每项"
+              << config.items << "条）" << std::endl;
+    bench_util::print_rule(90);
+    bench_util::print_header({{"队列", 12}, {"测试", 16}, {"生产(ns/条)", 14}, {"收到条数", 12}, {"丢失条数", 12}, {"等待次数", 12},
+                              {"校验", 0}});
+    bench_util::print_rule(90, '-');
+    
+    print_row("plain", "solo", run_solo<Plain>(config), config.items, 0, 0, "-");
+    print_row("overwrite", "solo", run_solo<Ring>(config), config.items, 0, 0, "-");
+    print_row("overwrite", "produce", run_produce(config), 0, config.items, 0, "-");
+    
+    int exit_code = 0;
+    for (int work_ns : config.work_ns) {
+        if (!report_threaded<Plain>("plain", config, work_ns)) exit_code = 1;
+        if (!report_threaded<Ring>("overwrite", config, work_ns)) exit_code = 1;
+    }
+    bench_util::print_rule(90);
+    
+    return exit_code;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "seqlock.hpp"
+
+// 覆盖最旧元素的有损环形队列（单生产者单消费者），用于指标、调试跟踪等宁可丢旧数据
+// 也不能让生产者等待的场景：enqueue永远成功，环满时直接覆盖消费者还没读到的最旧元素
+//
+// 每个槽位带一个序号戳：写位置p时先写2p+1（奇数表示正在写），写完数据后写2p+2。
+// 消费者读位置r时按seqlock方式校验：读数据前后的戳都等于2r+2才算读到完整的元素；
+// 戳比2r+2大说明该槽位已被后面的元素覆盖（被生产者套圈），此时跳到最旧的仍然有效的位置，
+// 并把跳过的元素数报告给调用者
+//
+// 生产者不读取消费者的位置，两端之间没有任何反压；T须可平凡复制
+template<typename T, size_t Size>
+class OverwriteRing {
+    static_assert((Size & (Size - 1)) == 0, "Size must be power of 2");
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> stamp{0};
+        T value;
+    };
+    
+    struct alignas(64) ProducerData {  // 避免false sharing
+        std::atomic<uint64_t> written{0};  // 已写完的元素数，消费者被套圈时据此重新定位
+    } producer_;
+    
+    struct alignas(64) ConsumerData {  // 避免false sharing
+        uint64_t position = 0;
+        std::atomic<uint64_t> overruns{0};  // 累计丢失的元素数，可由其他线程读取
+    } consumer_;
+    
+    struct alignas(64) BufferData {
+        Slot buffer[Size];
+    } buffer_data_;
+    
+    static constexpr size_t MASK = Size - 1;
+
+public:
+    using value_type = T;
+    
+    OverwriteRing() = default;
+    ~OverwriteRing() = default;
+    
+    // 禁止拷贝和移动
+    OverwriteRing(const OverwriteRing&) = delete;
+    OverwriteRing& operator=(const OverwriteRing&) = delete;
+    OverwriteRing(OverwriteRing&&) = delete;
+    OverwriteRing& operator=(OverwriteRing&&) = delete;
+    
+    // 生产者端：写入元素，环满时覆盖最旧的元素，永远返回true
+    bool enqueue(const T& item) {
+        const uint64_t position = producer_.written.load(std::memory_order_relaxed);
+        Slot& slot = buffer_data_.buffer[position & MASK];
+        // 直接赋值，调用方构造的临时对象可以不经过栈直接写入槽位
+        seqlock_detail::write(slot.stamp, 2 * position + 1, [&] { slot.value = item; });
+        producer_.written.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // 消费者端：读取下一个元素，没有新元素时返回false；lost为紧挨着本元素之前被覆盖而丢失的元素数
+    bool dequeue(T& item, size_t& lost) {
+        lost = 0;
+        while (true) {
+            const uint64_t position = consumer_.position;
+            const Slot& slot = buffer_data_.buffer[position & MASK];
+            const uint64_t expected = 2 * position + 2;
+            const uint64_t before = slot.stamp.load(std::memory_order_acquire);
+            if (before == expected) {
+                if (seqlock_detail::try_read(slot.stamp, before, [&] { item = slot.value; })) {
+                    consumer_.position = position + 1;
+                    return true;
+                }
+                // 读的过程中被覆盖，按套圈处理
+            } else if (before < expected) {
+                return false;  // 位置position尚未写入或正在写入
+            }
+            // 被套圈：跳到生产者当前位置之前Size-1个元素（生产者可能正在写最旧的那个槽位）
+            const uint64_t written = producer_.written.load(std::memory_order_acquire);
+            const uint64_t oldest = written > Size - 1 ? written - (Size - 1) : 0;
+            const uint64_t next = std::max(oldest, position + 1);
+            lost += next - position;
+            consumer_.overruns.store(consumer_.overruns.load(std::memory_order_relaxed) + (next - position),
+                                     std::memory_order_relaxed);
+            consumer_.position = next;
+        }
+    }
+    
+    bool dequeue(T& item) {
+        size_t lost;
+        return dequeue(item, lost);
+    }
+    
+    // 由消费者调用：已写入但尚未读取的元素数（被覆盖的部分不计，至多Size）
+    size_t size() const {
+        const uint64_t written = producer_.written.load(std::memory_order_acquire);
+        return static_cast<size_t>(std::min<uint64_t>(written - std::min(written, consumer_.position), Size));
+    }
+    
+    bool empty() const {
+        return size() == 0;
+    }
+    
+    static constexpr size_t capacity() {
+        return Size;
+    }
+    
+    // 累计因覆盖丢失的元素数
+    size_t overruns() const {
+        return consumer_.overruns.load(std::memory_order_relaxed);
+    }
+    
+    // 累计写入的元素数
+    size_t written() const {
+        return producer_.written.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define LFQ_PAYLOAD_COPY_X86 1
+#endif
+
+// 大消息体拷贝：运行时按CPU选择AVX-512/AVX2/标量实现，另有绕过缓存的流式（non-temporal）写入
+//
+// 生产者把1–16KB的消息体写进环形队列时，普通写入会先把目标缓存行读进自己的缓存（RFO），
+// 再把这些只有消费者才会读的行留在缓存里，挤掉生产者自己的工作集。流式写入直接写往内存，
+// 不占用生产者的缓存，但写入对其他核的可见顺序不再由普通的release保证，发布前须调用
+// store_fence()（sfence）
+//
+// SPSCPayloadWrite<StreamThreshold>是SPSCLockFreeQueue的写入策略：sizeof(T)不小于阈值时
+// 用流式写入并在发布tail前执行sfence，否则用SIMD普通写入
+
+namespace payload_copy {
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Avx2: return "avx2";
+        case Isa::Avx512: return "avx512";
+    }
+    return "?";
+}
+
+// 当前CPU支持的最宽指令集
+inline Isa detected_isa() {
+#if defined(LFQ_PAYLOAD_COPY_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+    if (__builtin_cpu_supports("avx2")) return Isa::Avx2;
+#endif
+    return Isa::Scalar;
+}
+
+namespace detail {
+
+using CopyFn = void (*)(void* dst, const void* src, size_t size);
+
+inline void copy_scalar(void* dst, const void* src, size_t size) {
+    std::memcpy(dst, src, size);
+}
+
+#ifdef LFQ_PAYLOAD_COPY_X86
+
+// 把dst对齐到Align字节：先用memcpy写开头不对齐的部分，返回已写的字节数
+template<size_t Align>
+inline size_t align_head(char* dst, const char* src, size_t size) {
+    const size_t head = std::min(size, static_cast<size_t>(-reinterpret_cast<uintptr_t>(dst) & (Align - 1)));
+    std::memcpy(dst, src, head);
+    return head;
+}
+
+// 标量版的流式写入：x86-64都支持SSE2的16字节non-temporal写
+inline void stream_scalar(void* dst, const void* src, size_t size) {
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    const size_t head = align_head<16>(d, s, size);
+    d += head;
+    s += head;
+    size -= head;
+    for (; size >= 64; size -= 64, d += 64, s += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+        const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), e);
+    }
+    std::memcpy(d, s, size);
+}
+
+__attribute__((target("avx2")))
+inline void copy_avx2(void* dst, const void* src, size_t size) {
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    for (; size >= 128; size -= 128, d += 128, s += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64));
+        const __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + 32), b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + 64), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + 96), e);
+    }
+    for (; size >= 32; size -= 32, d += 32, s += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+    }
+    std::memcpy(d, s, size);
+}
+
+__attribute__((target("avx2")))
+inline void stream_avx2(void* dst, const void* src, size_t size) {
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    const size_t head = align_head<32>(d, s, size);
+    d += head;
+    s += head;
+    size -= head;
+    for (; size >= 128; size -= 128, d += 128, s += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64));
+        const __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96), e);
+    }
+    for (; size >= 32; size -= 32, d += 32, s += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+    }
+    std::memcpy(d, s, size);
+}
+
+__attribute__((target("avx512f")))
+inline void copy_avx512(void* dst, const void* src, size_t size) {
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    for (; size >= 256; size -= 256, d += 256, s += 256) {
+        const __m512i a = _mm512_loadu_si512(s);
+        const __m512i b = _mm512_loadu_si512(s + 64);
+        const __m512i c = _mm512_loadu_si512(s + 128);
+        const __m512i e = _mm512_loadu_si512(s + 192);
+        _mm512_storeu_si512(d, a);
+        _mm512_storeu_si512(d + 64, b);
+        _mm512_storeu_si512(d + 128, c);
+        _mm512_storeu_si512(d + 192, e);
+    }
+    for (; size >= 64; size -= 64, d += 64, s += 64) {
+        _mm512_storeu_si512(d, _mm512_loadu_si512(s));
+    }
+    std::memcpy(d, s, size);
+}
+
+__attribute__((target("avx512f")))
+inline void stream_avx512(void* dst, const void* src, size_t size) {
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    const size_t head = align_head<64>(d, s, size);
+    d += head;
+    s += head;
+    size -= head;
+    for (; size >= 256; size -= 256, d += 256, s += 256) {
+        const __m512i a = _mm512_loadu_si512(s);
+        const __m512i b = _mm512_loadu_si512(s + 64);
+        const __m512i c = _mm512_loadu_si512(s + 128);
+        const __m512i e = _mm512_loadu_si512(s + 192);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(d), a);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(d + 64), b);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(d + 128), c);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(d + 192), e);
+    }
+    for (; size >= 64; size -= 64, d += 64, s += 64) {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(d), _mm512_loadu_si512(s));
+    }
+    std::memcpy(d, s, size);
+}
+
+#else
+
+inline void stream_scalar(void* dst, const void* src, size_t size) {
+    std::memcpy(dst, src, size);
+}
+
+#endif
+
+inline CopyFn copy_fn(Isa isa) {
+#ifdef LFQ_PAYLOAD_COPY_X86
+    switch (isa) {
+        case Isa::Avx512: return &copy_avx512;
+        case Isa::Avx2: return &copy_avx2;
+        case Isa::Scalar: break;
+    }
+#else
+    (void)isa;
+#endif
+    return &copy_scalar;
+}
+
+inline CopyFn stream_fn(Isa isa) {
+#ifdef LFQ_PAYLOAD_COPY_X86
+    switch (isa) {
+        case Isa::Avx512: return &stream_avx512;
+        case Isa::Avx2: return &stream_avx2;
+        case Isa::Scalar: break;
+    }
+#else
+    (void)isa;
+#endif
+    return &stream_scalar;
+}
+
+}  // namespace detail
+
+// 用指定指令集拷贝（基准对比用；isa须是detected_isa()支持的）
+inline void copy(Isa isa, void* dst, const void* src, size_t size) {
+    detail::copy_fn(isa)(dst, src, size);
+}
+
+inline void stream(Isa isa, void* dst, const void* src, size_t size) {
+    detail::stream_fn(isa)(dst, src, size);
+}
+
+// 用当前CPU支持的最宽指令集拷贝，首次调用时选定实现
+inline void copy(void* dst, const void* src, size_t size) {
+    static const detail::CopyFn fn = detail::copy_fn(detected_isa());
+    fn(dst, src, size);
+}
+
+// 流式写入，之后须先store_fence()再发布
+inline void stream(void* dst, const void* src, size_t size) {
+    static const detail::CopyFn fn = detail::stream_fn(detected_isa());
+    fn(dst, src, size);
+}
+
+// 让之前的流式写入先于之后的写入全局可见
+inline void store_fence() {
+#ifdef LFQ_PAYLOAD_COPY_X86
+    _mm_sfence();
+#endif
+}
+
+}  // namespace payload_copy
+
+// SPSCLockFreeQueue的写入策略，只用于可平凡复制的T：
+//   SPSCLockFreeQueue<Frame, 256, SPSCNoStats, SPSCPayloadWrite<>> queue;
+// sizeof(T) >= StreamThreshold时流式写入槽位（发布tail前sfence），否则SIMD普通写入
+template<size_t StreamThreshold = 4096>
+struct SPSCPayloadWrite {
+    template<typename T>
+    static constexpr bool streams = sizeof(T) >= StreamThreshold;
+    
+    template<typename T, typename U>
+    static void write(T& slot, U&& item) {
+        static_assert(std::is_trivially_copyable<T>::value, "SPSCPayloadWrite requires a trivially copyable T");
+        if constexpr (std::is_same<std::decay_t<U>, T>::value) {
+            put<T>(&slot, &item);
+        } else {
+            const T value(std::forward<U>(item));
+            put<T>(&slot, &value);
+        }
+    }
+    
+    template<typename T>
+    static void before_publish() {
+        if constexpr (streams<T>) {
+            payload_copy::store_fence();
+        }
+    }
+
+private:
+    template<typename T>
+    static void put(T* slot, const T* item) {
+        if constexpr (streams<T>) {
+            payload_copy::stream(slot, item, sizeof(T));
+        } else {
+            payload_copy::copy(slot, item, sizeof(T));
+        }
+    }
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 硬件性能计数器事件，顺序即输出顺序
+enum PerfEvent {
+    kPerfCycles = 0,
+    kPerfInstructions,
+    kPerfBranchMisses,
+    kPerfL1DMisses,
+    kPerfLLCMisses,
+    kPerfHitm,          // 跨核HITM/snoop事件，编码与CPU型号相关，需通过原始事件号指定
+    kPerfEventCount
+};
+
+inline const char* perf_event_name(int event) {
+    static const char* names[kPerfEventCount] = {
+        "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "hitm"
+    };
+    return names[event];
+}
+
+// 一次测量得到的计数值，未能打开的事件为NaN
+struct PerfSample {
+    bool valid = false;
+    std::array<double, kPerfEventCount> values;
+
+    PerfSample() {
+        values.fill(std::nan(""));
+    }
+};
+
+// 基于perf_event_open的计数器组
+// 以cycles为组长，在调用线程上打开并设置inherit，之后创建的生产者/消费者线程
+// 也会被计入；线程退出时内核把子计数累加回组，因此必须在join之后调用stop()
+class PerfCounterGroup {
+private:
+    std::array<int, kPerfEventCount> fds_;
+    std::array<int, kPerfEventCount> slot_;  // 事件在组读取结果中的位置，-1表示未打开
+    int leader_fd_ = -1;
+    int num_opened_ = 0;
+    std::string error_;
+
+#ifdef __linux__
+    static int open_event(uint32_t type, uint64_t config, int group_fd) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group_fd == -1 ? 1 : 0;  // 只有组长需要禁用，由组长统一启停
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;                 // perf_event_paranoid<=2时非特权用户也能打开
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+
+    static uint64_t cache_config(uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+public:
+    // hitm_raw_config为0时不采集HITM
+    explicit PerfCounterGroup(uint64_t hitm_raw_config = 0) {
+        fds_.fill(-1);
+        slot_.fill(-1);
+
+#ifdef __linux__
+        leader_fd_ = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (leader_fd_ < 0) {
+            error_ = std::string("perf_event_open失败: ") + strerror(errno);
+            std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+            int level = 0;
+            if (paranoid >> level) {
+                error_ += "（perf_event_paranoid=" + std::to_string(level) + "）";
+            }
+            return;
+        }
+        fds_[kPerfCycles] = leader_fd_;
+        slot_[kPerfCycles] = num_opened_++;
+
+        // 组员打开失败（硬件不支持或计数器不足）时跳过，不影响其余事件
+        auto add_member = [&](int event, uint32_t type, uint64_t config) {
+            int fd = open_event(type, config, leader_fd_);
+            if (fd >= 0) {
+                fds_[event] = fd;
+                slot_[event] = num_opened_++;
+            }
+        };
+        add_member(kPerfInstructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        add_member(kPerfBranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        add_member(kPerfL1DMisses, PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_L1D));
+        add_member(kPerfLLCMisses, PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_LL));
+        if (hitm_raw_config != 0) {
+            add_member(kPerfHitm, PERF_TYPE_RAW, hitm_raw_config);
+        }
+#else
+        (void)hitm_raw_config;
+        error_ = "当前平台不支持perf_event_open";
+#endif
+    }
+
+    ~PerfCounterGroup() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    // 禁止拷贝和移动
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+    PerfCounterGroup(PerfCounterGroup&&) = delete;
+    PerfCounterGroup& operator=(PerfCounterGroup&&) = delete;
+
+    bool available() const {
+        return leader_fd_ >= 0;
+    }
+
+    const std::string& error() const {
+        return error_;
+    }
+
+    // 清零并开始计数
+    void start() {
+#ifdef __linux__
+        if (!available()) return;
+        ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // 停止计数并读取，计数器被复用时按运行时间比例放大
+    PerfSample stop() {
+        PerfSample sample;
+#ifdef __linux__
+        if (!available()) return sample;
+        ioctl(leader_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // 布局: nr, time_enabled, time_running, values[nr]
+        uint64_t buffer[3 + kPerfEventCount];
+        ssize_t n = read(leader_fd_, buffer, sizeof(buffer));
+        if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(num_opened_)) {
+            return sample;
+        }
+
+        uint64_t time_enabled = buffer[1];
+        uint64_t time_running = buffer[2];
+        if (time_running == 0) {
+            return sample;  // 组从未被调度上PMU
+        }
+        double scale = static_cast<double>(time_enabled) / time_running;
+
+        for (int event = 0; event < kPerfEventCount; ++event) {
+            if (slot_[event] >= 0) {
+                sample.values[event] = buffer[3 + slot_[event]] * scale;
+            }
+        }
+        sample.valid = true;
+#endif
+        return sample;
+    }
+};
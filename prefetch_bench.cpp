@@ -0,0 +1,288 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "spsc_lockfree_queue.hpp"
+#include "bench_util.hpp"
+
+// 槽位预取基准：扫描预取距离和消息大小，看SPSCPrefetch在什么情况下有用
+//   drain     队列中积压backlog条消息，且槽位已被挤出缓存（相当于刚被另一个核写完），
+//             单线程逐条出队并读取消息的每个缓存行，测每条耗时
+//   fill      槽位已被挤出缓存，单线程逐条入队backlog条消息，测每条耗时（写意图预取）
+//   threaded  生产者与消费者各一个线程全速传输，测端到端每条耗时
+// 距离0为SPSCNoPrefetch，“加速”为相对距离0的耗时比
+
+constexpr size_t kSlots = 4096;
+constexpr size_t kSizes[] = {64, 256, 1024, 4096};
+constexpr size_t kDistances[] = {0, 1, 2, 4, 8, 16};
+
+template<size_t N>
+struct alignas(64) Message {
+    uint64_t words[N / sizeof(uint64_t)];
+};
+
+template<size_t Distance>
+using PrefetchPolicy = std::conditional_t<Distance == 0, SPSCNoPrefetch, SPSCPrefetch<Distance == 0 ? 1 : Distance>>;
+
+template<size_t N, size_t Distance>
+using BenchQueue = SPSCLockFreeQueue<Message<N>, kSlots, SPSCNoStats, SPSCAssignWrite, PrefetchPolicy<Distance>>;
+
+struct PrefetchBenchConfig {
+    std::vector<size_t> sizes{std::begin(kSizes), std::end(kSizes)};
+    std::vector<size_t> distances{std::begin(kDistances), std::end(kDistances)};
+    size_t backlog = kSlots - 1;
+    size_t items = 1000000;   // threaded模式的消息数
+    size_t evict_mb = 64;
+    int repetitions = 5;
+    std::string filter;
+};
+
+struct PrefetchResult {
+    double ns = 0.0;
+    bool valid = true;
+};
+
+// 写一遍比末级缓存大的缓冲区，把队列槽位挤出缓存
+void evict_caches(std::vector<uint64_t>& evict) {
+    for (size_t i = 0; i < evict.size(); i += 8) {
+        evict[i] += 1;
+    }
+}
+
+template<size_t N>
+void fill_message(Message<N>& message, uint64_t sequence) {
+    message.words[0] = sequence;
+    message.words[N / sizeof(uint64_t) - 1] = sequence;
+}
+
+// 读取消息的每个缓存行并校验首尾序号
+template<size_t N>
+bool consume_message(const Message<N>& message, uint64_t sequence, uint64_t& sum) {
+    constexpr size_t kWords = N / sizeof(uint64_t);
+    for (size_t w = 0; w < kWords; w += 8) {
+        sum += message.words[w];
+    }
+    return message.words[0] == sequence && message.words[kWords - 1] == sequence;
+}
+
+template<size_t N, size_t Distance>
+PrefetchResult run_drain(const PrefetchBenchConfig& config, std::vector<uint64_t>& evict) {
+    auto queue = std::make_unique<BenchQueue<N, Distance>>();
+    PrefetchResult result;
+    Message<N> message{};
+    uint64_t sum = 0;
+    uint64_t sequence = 0;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        const uint64_t first = sequence;
+        for (size_t i = 0; i < config.backlog; ++i) {
+            fill_message(message, sequence++);
+            queue->enqueue(message);
+        }
+        evict_caches(evict);
+        
+        const int64_t begin = bench_util::steady_now_ns();
+        for (size_t i = 0; i < config.backlog; ++i) {
+            if (!queue->dequeue(message) || !consume_message(message, first + i, sum)) {
+                result.valid = false;
+            }
+        }
+        const double ns = static_cast<double>(bench_util::steady_now_ns() - begin) / config.backlog;
+        result.ns = rep == 0 ? ns : std::min(result.ns, ns);
+    }
+    bench_util::do_not_optimize(sum);  // 防止读取被优化掉
+    return result;
+}
+
+template<size_t N, size_t Distance>
+PrefetchResult run_fill(const PrefetchBenchConfig& config, std::vector<uint64_t>& evict) {
+    auto queue = std::make_unique<BenchQueue<N, Distance>>();
+    PrefetchResult result;
+    Message<N> message{};
+    uint64_t sum = 0;
+    uint64_t sequence = 0;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        const uint64_t first = sequence;
+        evict_caches(evict);
+        
+        const int64_t begin = bench_util::steady_now_ns();
+        for (size_t i = 0; i < config.backlog; ++i) {
+            fill_message(message, sequence++);
+            queue->enqueue(message);
+        }
+        const double ns = static_cast<double>(bench_util::steady_now_ns() - begin) / config.backlog;
+        result.ns = rep == 0 ? ns : std::min(result.ns, ns);
+        
+        for (size_t i = 0; i < config.backlog; ++i) {
+            if (!queue->dequeue(message) || !consume_message(message, first + i, sum)) {
+                result.valid = false;
+            }
+        }
+    }
+    bench_util::do_not_optimize(sum);
+    return result;
+}
+
+template<size_t N, size_t Distance>
+PrefetchResult run_threaded(const PrefetchBenchConfig& config, std::vector<uint64_t>&) {
+    PrefetchResult result;
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        auto queue = std::make_unique<BenchQueue<N, Distance>>();
+        bool valid = true;
+        std::thread consumer([&]() {
+            Message<N> message;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < config.items; ++i) {
+                while (!queue->dequeue(message)) std::this_thread::yield();
+                valid = consume_message(message, i, sum) && valid;
+            }
+            bench_util::do_not_optimize(sum);
+        });
+        
+        Message<N> message{};
+        const int64_t begin = bench_util::steady_now_ns();
+        for (size_t i = 0; i < config.items; ++i) {
+            fill_message(message, i);
+            while (!queue->enqueue(message)) std::this_thread::yield();
+        }
+        consumer.join();
+        const double ns = static_cast<double>(bench_util::steady_now_ns() - begin) / config.items;
+        result.ns = rep == 0 ? ns : std::min(result.ns, ns);
+        result.valid = result.valid && valid;
+    }
+    return result;
+}
+
+// 按运行时选择的大小和距离展开编译期参数
+template<template<size_t, size_t> class Mode, size_t N, size_t... Ds>
+bool run_distances(const PrefetchBenchConfig& config, const char* name, std::vector<uint64_t>& evict,
+                   std::index_sequence<Ds...>) {
+    bool ok = true;
+    double baseline = 0.0;
+    auto run_one = [&](auto distance) {
+        constexpr size_t D = decltype(distance)::value;
+        if (std::find(config.distances.begin(), config.distances.end(), D) == config.distances.end()) return;
+        const PrefetchResult r = Mode<N, D>::run(config, evict);
+        if (D == 0) baseline = r.ns;
+        std::cout << std::setw(12) << name
+                  << std::setw(8) << N
+                  << std::setw(8) << D
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.ns;
+        if (baseline > 0.0) {
+            std::cout << std::setw(10) << std::setprecision(2) << baseline / r.ns;
+        } else {
+            std::cout << std::setw(10) << "-";
+        }
+        std::cout << (r.valid ? "通过" : "失败") << std::endl;
+        ok = ok && r.valid;
+    };
+    (run_one(std::integral_constant<size_t, kDistances[Ds]>{}), ...);
+    return ok;
+}
+
+template<template<size_t, size_t> class Mode, size_t... Ns>
+bool run_mode(const PrefetchBenchConfig& config, const char* name, std::vector<uint64_t>& evict,
+              std::index_sequence<Ns...>) {
+    if (!config.filter.empty() && std::string(name).find(config.filter) == std::string::npos) return true;
+    bool ok = true;
+    auto run_size = [&](auto size) {
+        constexpr size_t N = decltype(size)::value;
+        if (std::find(config.sizes.begin(), config.sizes.end(), N) == config.sizes.end()) return;
+        ok = run_distances<Mode, N>(config, name, evict, std::make_index_sequence<std::size(kDistances)>{}) && ok;
+    };
+    (run_size(std::integral_constant<size_t, kSizes[Ns]>{}), ...);
+    return ok;
+}
+
+template<size_t N, size_t D>
+struct DrainMode {
+    static PrefetchResult run(const PrefetchBenchConfig& c, std::vector<uint64_t>& e) { return run_drain<N, D>(c, e); }
+};
+
+template<size_t N, size_t D>
+struct FillMode {
+    static PrefetchResult run(const PrefetchBenchConfig& c, std::vector<uint64_t>& e) { return run_fill<N, D>(c, e); }
+};
+
+template<size_t N, size_t D>
+struct ThreadedMode {
+    static PrefetchResult run(const PrefetchBenchConfig& c, std::vector<uint64_t>& e) { return run_threaded<N, D>(c, e); }
+};
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --filter=STR         只运行名称包含STR的模式（drain、fill、threaded）\n"
+              << "  --sizes=LIST         消息字节数列表，取自64,256,1024,4096（默认全部）\n"
+              << "  --distances=LIST     预取距离列表，取自0,1,2,4,8,16，0为不预取（默认全部）\n"
+              << "  --backlog=N          drain/fill模式的积压条数，不超过4095（默认4095）\n"
+              << "  --items=N            threaded模式的消息数（默认1000000）\n"
+              << "  --evict-mb=N         挤出缓存用的缓冲区大小（默认64）\n"
+              << "  --repetitions=N      每项重复次数，取最好的一次（默认5）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+// list中的值都取自allowed
+template<size_t K>
+bool all_in(const std::vector<size_t>& list, const size_t (&allowed)[K]) {
+    return !list.empty() && std::all_of(list.begin(), list.end(), [&](size_t v) {
+        return std::find(std::begin(allowed), std::end(allowed), v) != std::end(allowed);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    PrefetchBenchConfig config;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--filter") {
+            config.filter = value;
+        } else if (key == "--sizes") {
+            config.sizes = bench_util::parse_size_list(value);
+        } else if (key == "--distances") {
+            config.distances = bench_util::parse_size_list(value);
+        } else if (key == "--backlog") {
+            config.backlog = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--items") {
+            config.items = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--evict-mb") {
+            config.evict_mb = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--repetitions") {
+            config.repetitions = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (!all_in(config.sizes, kSizes) || !all_in(config.distances, kDistances) || config.backlog == 0 ||
+        config.backlog > kSlots - 1 || config.items == 0 || config.evict_mb == 0 || config.repetitions <= 0) {
+        std::cerr << "参数超出范围（大小和距离取自列出的值，积压条数为1到4095，其余为正）" << std::endl;
+        return 1;
+    }
+    
+    std::vector<uint64_t> evict((config.evict_mb << 20) / sizeof(uint64_t));
+    
+    std::cout << "槽位预取基准（" << kSlots << "槽位，积压" << config.backlog << "条，threaded "
+              << config.items << "条，挤出缓存" << config.evict_mb << "MB）" << std::endl;
+    bench_util::print_rule(64);
+    bench_util::print_header({{"模式", 12}, {"字节", 8}, {"距离", 8}, {"每条(ns)", 12}, {"加速", 10}, {"校验", 0}});
+    bench_util::print_rule(64, '-');
+    
+    constexpr auto sizes = std::make_index_sequence<std::size(kSizes)>{};
+    bool ok = run_mode<DrainMode>(config, "drain", evict, sizes);
+    ok = run_mode<FillMode>(config, "fill", evict, sizes) && ok;
+    ok = run_mode<ThreadedMode>(config, "threaded", evict, sizes) && ok;
+    bench_util::print_rule(64);
+    
+    return ok ? 0 : 1;
+}
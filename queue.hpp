@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "spsc_lockfree_queue.hpp"
+#include "mpmc_bounded_queue.hpp"
+#include "locked_queue.hpp"
+#include "double_buffer_spsc.hpp"
+
+// 基于策略的统一队列：按生产者/消费者数量、容量、存储、等待和统计策略在编译期选择实现
+//
+//   单生产者单消费者 + 编译期容量      → SPSCLockFreeQueue
+//   单生产者单消费者 + 运行时容量      → MPMCBoundedQueue（两端都不需要CAS）
+//   多生产者或多消费者                 → MPMCBoundedQueue（多的一侧用CAS认领）
+//   DoubleBufferStorage                → DoubleBufferSPSC（仅单生产者单消费者）
+//   BlockingWait                       → LockedQueue（只有加锁实现能在条件变量上阻塞）
+//
+// 所有组合提供相同的接口：try_push/try_pop/try_push_bulk/try_pop_bulk/push/pop/flush/flushed/empty/size/capacity
+
+// 生产者/消费者数量
+struct SingleThread {};
+struct MultiThread {};
+
+// 存储策略：队列状态内联在对象中、放在堆上，或以双缓冲批量发布
+struct InlineStorage {};
+struct HeapStorage {};          // 大容量的内联环可达数MB，放在堆上避免栈溢出
+struct DoubleBufferStorage {};
+
+// 等待策略：push/pop在队列满或空时每次重试前调用pause()
+struct SpinWait {
+    static const char* name() { return "spin"; }
+    
+    static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+};
+
+struct YieldWait {
+    static const char* name() { return "yield"; }
+    
+    static void pause() {
+        std::this_thread::yield();
+    }
+};
+
+// pop在条件变量上阻塞，push在队列满时让出CPU
+struct BlockingWait {
+    static const char* name() { return "blocking"; }
+    
+    static void pause() {
+        std::this_thread::yield();
+    }
+};
+
+// 容量为0表示在构造函数中指定
+constexpr size_t kDynamicCapacity = 0;
+
+// 各实现的适配层，构造参数统一为(容量, 批大小)
+template<typename T, size_t Capacity, typename Stats>
+class SpscRingBackend {
+private:
+    SPSCLockFreeQueue<T, Capacity, Stats> queue_;
+
+public:
+    static constexpr bool has_bulk = true;
+    
+    SpscRingBackend(size_t, size_t) {}
+    template<typename U>
+    bool try_push(U&& item) { return queue_.enqueue(std::forward<U>(item)); }
+    bool try_pop(T& item) { return queue_.dequeue(item); }
+    size_t try_push_bulk(const T* items, size_t count) { return queue_.enqueue_bulk(items, count); }
+    size_t try_pop_bulk(T* items, size_t max_count) { return queue_.dequeue_bulk(items, max_count); }
+    void flush() {}
+    bool flushed() const { return true; }
+    bool empty() const { return queue_.empty(); }
+    size_t size() const { return queue_.size(); }
+    size_t capacity() const { return queue_.capacity(); }
+    SPSCQueueStatsSnapshot snapshot() const { return queue_.snapshot(); }
+};
+
+template<typename T, bool MultiProducer, bool MultiConsumer>
+class SequenceRingBackend {
+private:
+    MPMCBoundedQueue<T, MultiProducer, MultiConsumer> queue_;
+
+public:
+    static constexpr bool has_bulk = false;  // 每个槽位单独认领，批量接口逐个循环
+    
+    SequenceRingBackend(size_t capacity, size_t) : queue_(capacity) {}
+    template<typename U>
+    bool try_push(U&& item) { return queue_.enqueue(std::forward<U>(item)); }
+    bool try_pop(T& item) { return queue_.dequeue(item); }
+    
+    size_t try_push_bulk(const T* items, size_t count) {
+        size_t n = 0;
+        while (n < count && queue_.enqueue(items[n])) ++n;
+        return n;
+    }
+    
+    size_t try_pop_bulk(T* items, size_t max_count) {
+        size_t n = 0;
+        while (n < max_count && queue_.dequeue(items[n])) ++n;
+        return n;
+    }
+    
+    void flush() {}
+    bool flushed() const { return true; }
+    bool empty() const { return queue_.empty(); }
+    size_t size() const { return queue_.size(); }
+    size_t capacity() const { return queue_.capacity(); }
+    SPSCQueueStatsSnapshot snapshot() const { return SPSCQueueStatsSnapshot{}; }
+};
+
+template<typename T>
+class LockedBackend {
+private:
+    LockedQueue<T> queue_;
+
+public:
+    static constexpr bool has_bulk = true;
+    
+    LockedBackend(size_t capacity, size_t) : queue_(capacity) {}
+    template<typename U>
+    bool try_push(U&& item) { return queue_.enqueue(std::forward<U>(item)); }
+    bool try_pop(T& item) { return queue_.dequeue(item); }
+    size_t try_push_bulk(const T* items, size_t count) { return queue_.enqueue_bulk(items, count); }
+    size_t try_pop_bulk(T* items, size_t max_count) { return queue_.dequeue_bulk(items, max_count); }
+    void pop_blocking(T& item) { queue_.dequeue_blocking(item); }
+    void flush() {}
+    bool flushed() const { return true; }
+    bool empty() const { return queue_.empty(); }
+    size_t size() const { return queue_.size(); }
+    size_t capacity() const { return queue_.capacity(); }
+    SPSCQueueStatsSnapshot snapshot() const { return SPSCQueueStatsSnapshot{}; }
+};
+
+// 写满一批或调用flush()时切换缓冲区；只有消费者读空后才能切换，否则会清掉未读数据
+// 生产者空闲时必须调用flush()，否则不足一批的数据不会对消费者可见
+template<typename T>
+class DoubleBufferBackend {
+private:
+    DoubleBufferSPSC<T> queue_;
+    size_t batch_size_;
+    size_t pending_ = 0;  // 只由生产者访问
+
+public:
+    static constexpr bool has_bulk = true;
+    
+    DoubleBufferBackend(size_t capacity, size_t batch)
+        : queue_(capacity), batch_size_(batch ? batch : std::max<size_t>(capacity / 4, 1)) {}
+    
+    template<typename U>
+    bool try_push(U&& item) {
+        if (!queue_.enqueue(std::forward<U>(item))) {
+            flush();
+            return false;
+        }
+        if (++pending_ >= batch_size_) flush();
+        return true;
+    }
+    
+    size_t try_push_bulk(const T* items, size_t count) {
+        const size_t n = queue_.enqueue_bulk(items, count);
+        pending_ += n;
+        if (n < count || pending_ >= batch_size_) flush();
+        return n;
+    }
+    
+    bool try_pop(T& item) { return queue_.dequeue(item); }
+    
+    size_t try_pop_bulk(T* items, size_t max_count) { return queue_.dequeue_bulk(items, max_count); }
+    
+    void flush() {
+        if (pending_ > 0 && !queue_.has_data()) {
+            queue_.swap_buffers();
+            pending_ = 0;
+        }
+    }
+    
+    bool flushed() const { return pending_ == 0; }
+    
+    // 消费者视角：已发布的数据是否读完
+    bool empty() const { return !queue_.has_data(); }
+    
+    // 未发布的写缓冲加上读缓冲中尚未读取的部分
+    size_t size() const { return queue_.size(); }
+    
+    size_t capacity() const { return queue_.capacity(); }
+    
+    size_t batch_size() const { return batch_size_; }
+    
+    SPSCQueueStatsSnapshot snapshot() const { return SPSCQueueStatsSnapshot{}; }
+};
+
+// 按策略选出实现
+template<typename T, bool SingleProducer, bool SingleConsumer, size_t Capacity,
+         typename Storage, typename Wait, typename Stats>
+struct QueueBackendSelector {
+    using type = std::conditional_t<
+        std::is_same<Wait, BlockingWait>::value, LockedBackend<T>,
+        std::conditional_t<
+            std::is_same<Storage, DoubleBufferStorage>::value, DoubleBufferBackend<T>,
+            std::conditional_t<
+                SingleProducer && SingleConsumer && Capacity != kDynamicCapacity,
+                SpscRingBackend<T, Capacity, Stats>,
+                SequenceRingBackend<T, !SingleProducer, !SingleConsumer>>>>;
+};
+
+// 存储策略决定实现对象放在哪里
+template<typename Backend, typename Storage>
+class QueueStorage {
+private:
+    Backend backend_;
+
+public:
+    QueueStorage(size_t capacity, size_t batch) : backend_(capacity, batch) {}
+    Backend& get() { return backend_; }
+    const Backend& get() const { return backend_; }
+};
+
+template<typename Backend>
+class QueueStorage<Backend, HeapStorage> {
+private:
+    std::unique_ptr<Backend> backend_;
+
+public:
+    QueueStorage(size_t capacity, size_t batch) : backend_(std::make_unique<Backend>(capacity, batch)) {}
+    Backend& get() { return *backend_; }
+    const Backend& get() const { return *backend_; }
+};
+
+template<typename T,
+         typename Producers = SingleThread,
+         typename Consumers = SingleThread,
+         size_t Capacity = 1024,
+         typename Storage = InlineStorage,
+         typename Wait = YieldWait,
+         typename Stats = SPSCNoStats>
+class Queue {
+public:
+    static constexpr bool kSingleProducer = std::is_same<Producers, SingleThread>::value;
+    static constexpr bool kSingleConsumer = std::is_same<Consumers, SingleThread>::value;
+    static constexpr bool kBlocking = std::is_same<Wait, BlockingWait>::value;
+    
+    using value_type = T;
+    using wait_policy = Wait;
+    using stats_policy = Stats;
+    using backend_type = typename QueueBackendSelector<T, kSingleProducer, kSingleConsumer, Capacity,
+                                                       Storage, Wait, Stats>::type;
+    static constexpr bool has_bulk = backend_type::has_bulk;
+    
+    static_assert(!std::is_same<Storage, DoubleBufferStorage>::value || (kSingleProducer && kSingleConsumer),
+                  "double buffering requires a single producer and a single consumer");
+    static_assert(std::is_same<Stats, SPSCNoStats>::value ||
+                      std::is_same<backend_type, SpscRingBackend<T, Capacity, Stats>>::value,
+                  "stats policy is only supported by the SPSC ring");
+
+private:
+    QueueStorage<backend_type, Storage> storage_;
+
+public:
+    // 编译期容量非0时capacity必须与之一致；batch只对双缓冲有效，0表示容量/4
+    explicit Queue(size_t capacity = Capacity, size_t batch = 0)
+        : storage_(capacity, batch) {
+        assert(capacity != kDynamicCapacity && (Capacity == kDynamicCapacity || capacity == Capacity));
+    }
+    
+    // 禁止拷贝和移动
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+    Queue(Queue&&) = delete;
+    Queue& operator=(Queue&&) = delete;
+    
+    // 非阻塞入队，队列满时返回false且不移动item
+    template<typename U>
+    bool try_push(U&& item) {
+        return storage_.get().try_push(std::forward<U>(item));
+    }
+    
+    // 非阻塞出队，队列空时返回false
+    bool try_pop(T& item) {
+        return storage_.get().try_pop(item);
+    }
+    
+    // 批量入队，返回实际入队数量；实现没有原生批量接口时逐个入队（见has_bulk）
+    size_t try_push_bulk(const T* items, size_t count) {
+        return storage_.get().try_push_bulk(items, count);
+    }
+    
+    // 批量出队，返回实际出队数量
+    size_t try_pop_bulk(T* items, size_t max_count) {
+        return storage_.get().try_pop_bulk(items, max_count);
+    }
+    
+    // 入队，队列满时按等待策略重试
+    template<typename U>
+    void push(U&& item) {
+        while (!try_push(std::forward<U>(item))) {  // 失败时item未被移动，可以安全重试
+            flush();
+            Wait::pause();
+        }
+    }
+    
+    // 出队，队列空时按等待策略重试或阻塞
+    void pop(T& item) {
+        if constexpr (kBlocking) {
+            storage_.get().pop_blocking(item);
+        } else {
+            while (!try_pop(item)) {
+                Wait::pause();
+            }
+        }
+    }
+    
+    // 生产者端：发布尚未对消费者可见的数据（只有双缓冲需要）
+    void flush() {
+        storage_.get().flush();
+    }
+    
+    bool flushed() const {
+        return storage_.get().flushed();
+    }
+    
+    bool empty() const {
+        return storage_.get().empty();
+    }
+    
+    // 获取当前队列大小（近似值）
+    size_t size() const {
+        return storage_.get().size();
+    }
+    
+    size_t capacity() const {
+        return storage_.get().capacity();
+    }
+    
+    // 读取统计快照，只有SPSC环支持统计策略，其余实现恒为全0
+    SPSCQueueStatsSnapshot snapshot() const {
+        return storage_.get().snapshot();
+    }
+    
+    backend_type& backend() {
+        return storage_.get();
+    }
+};
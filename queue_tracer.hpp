@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "spsc_lockfree_queue.hpp"
+#include "double_buffer_spsc.hpp"
+
+// 读取跟踪时钟：x86上为TSC，其他平台退化为steady_clock的计数
+inline uint64_t read_trace_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// 一条被采样消息的跟踪记录
+struct TraceRecord {
+    uint32_t queue_id;
+    uint32_t depth;          // 入队时的队列深度（含本条）
+    uint64_t seq;            // 被采样消息在该队列中的序号
+    uint64_t enqueue_tick;
+    uint64_t dequeue_tick;
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord layout is part of the binary trace format");
+
+enum class TraceFormat {
+    Binary,       // 紧凑二进制，格式见QueueTracer
+    ChromeJson    // Chrome trace JSON，可直接在chrome://tracing或Perfetto中打开
+};
+
+// 跟踪导出器：每个被跟踪的队列有一个独立的跟踪环（队列的消费者写、导出线程读），
+// 后台线程定期把跟踪环中的记录写入文件，热路径上不做任何I/O
+//
+// 二进制格式（小端）：
+//   文件头  "LFQTRACE" | u32 版本(1) | u32 保留 | f64 每微秒时钟数
+//   记录    TraceRecord × N
+//   文件尾  u32 队列数 | 每个队列: u32 id, u32 名称长度, 名称字节 | u64 记录数 | "LFQTEND\0"
+class QueueTracer {
+public:
+    static constexpr size_t kRingSize = 4096;
+    using Ring = SPSCLockFreeQueue<TraceRecord, kRingSize>;
+
+private:
+    struct TracedQueueState {
+        std::string name;
+        Ring ring;
+        std::atomic<size_t> dropped{0};  // 跟踪环满时丢弃的记录数，只由队列的消费者写
+    };
+    
+    std::string path_;
+    TraceFormat format_;
+    std::chrono::milliseconds flush_interval_;
+    
+    std::mutex mutex_;                    // 保护states_和文件，不在热路径上
+    std::vector<std::unique_ptr<TracedQueueState>> states_;
+    std::ofstream out_;
+    std::thread exporter_;
+    std::atomic<bool> running_{false};
+    
+    uint64_t start_tick_ = 0;
+    double ticks_per_us_ = 1.0;
+    std::atomic<size_t> exported_{0};
+    bool first_event_ = true;
+    
+    // 用steady_clock标定跟踪时钟频率
+    void calibrate() {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = read_trace_clock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t c1 = read_trace_clock();
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        ticks_per_us_ = us > 0.0 ? (c1 - c0) / us : 1.0;
+        start_tick_ = c1;
+    }
+    
+    template<typename T>
+    void write_raw(const T& value) {
+        out_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    
+    // 队列名写入JSON前转义引号和反斜杠
+    static std::string escape(const std::string& name) {
+        std::string out;
+        for (char c : name) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+    
+    double to_us(uint64_t tick) const {
+        return tick >= start_tick_ ? (tick - start_tick_) / ticks_per_us_ : 0.0;
+    }
+    
+    void write_header() {
+        if (format_ == TraceFormat::Binary) {
+            out_.write("LFQTRACE", 8);
+            write_raw(uint32_t{1});
+            write_raw(uint32_t{0});
+            write_raw(ticks_per_us_);
+        } else {
+            out_ << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        }
+    }
+    
+    void write_record(const TraceRecord& record) {
+        if (format_ == TraceFormat::Binary) {
+            write_raw(record);
+        } else {
+            // 每条消息一个完整事件（入队到出队），外加一个深度计数器事件
+            const std::string name = escape(states_[record.queue_id]->name);
+            const double ts = to_us(record.enqueue_tick);
+            const double dur = record.dequeue_tick > record.enqueue_tick
+                                   ? (record.dequeue_tick - record.enqueue_tick) / ticks_per_us_ : 0.0;
+            out_ << (first_event_ ? "\n" : ",\n")
+                 << "{\"name\": \"" << name << "\", \"cat\": \"queue\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                 << record.queue_id << ", \"ts\": " << ts << ", \"dur\": " << dur
+                 << ", \"args\": {\"seq\": " << record.seq << ", \"depth\": " << record.depth << "}},\n"
+                 << "{\"name\": \"" << name << " depth\", \"ph\": \"C\", \"pid\": 1, \"ts\": " << ts
+                 << ", \"args\": {\"depth\": " << record.depth << "}}";
+            first_event_ = false;
+        }
+        exported_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    void write_footer() {
+        if (format_ == TraceFormat::Binary) {
+            write_raw(static_cast<uint32_t>(states_.size()));
+            for (size_t id = 0; id < states_.size(); ++id) {
+                const std::string& name = states_[id]->name;
+                write_raw(static_cast<uint32_t>(id));
+                write_raw(static_cast<uint32_t>(name.size()));
+                out_.write(name.data(), name.size());
+            }
+            write_raw(static_cast<uint64_t>(exported_.load()));
+            out_.write("LFQTEND", 8);
+        } else {
+            // 线程名元数据，让每个队列在时间线上单独成行
+            for (size_t id = 0; id < states_.size(); ++id) {
+                out_ << (first_event_ ? "\n" : ",\n")
+                     << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << id
+                     << ", \"args\": {\"name\": \"" << escape(states_[id]->name) << "\"}}";
+                first_event_ = false;
+            }
+            out_ << "\n]}\n";
+        }
+    }
+    
+    // 把所有跟踪环中的记录写入文件
+    void drain() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TraceRecord record;
+        for (auto& state : states_) {
+            while (state->ring.dequeue(record)) {
+                write_record(record);
+            }
+        }
+        out_.flush();
+    }
+
+public:
+    explicit QueueTracer(const std::string& path, TraceFormat format = TraceFormat::Binary,
+                         std::chrono::milliseconds flush_interval = std::chrono::milliseconds(10))
+        : path_(path), format_(format), flush_interval_(flush_interval) {}
+    
+    ~QueueTracer() {
+        stop();
+    }
+    
+    // 禁止拷贝和移动
+    QueueTracer(const QueueTracer&) = delete;
+    QueueTracer& operator=(const QueueTracer&) = delete;
+    QueueTracer(QueueTracer&&) = delete;
+    QueueTracer& operator=(QueueTracer&&) = delete;
+    
+    // 注册一个被跟踪的队列，返回的指针在tracer析构前有效
+    Ring* register_queue(const std::string& name, uint32_t& queue_id, std::atomic<size_t>*& dropped) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto state = std::make_unique<TracedQueueState>();
+        state->name = name;
+        queue_id = static_cast<uint32_t>(states_.size());
+        dropped = &state->dropped;
+        states_.push_back(std::move(state));
+        return &states_.back()->ring;
+    }
+    
+    // 打开输出文件并启动导出线程，失败时返回false
+    bool start() {
+        if (running_.load()) return true;
+        
+        calibrate();
+        out_.open(path_, std::ios::binary | std::ios::trunc);
+        if (!out_) return false;
+        out_ << std::fixed << std::setprecision(3);
+        write_header();
+        
+        running_.store(true);
+        exporter_ = std::thread([this]() {
+            while (running_.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(flush_interval_);
+                drain();
+            }
+        });
+        return true;
+    }
+    
+    // 停止导出线程，写出剩余记录和文件尾；应在被跟踪队列的消费者线程结束后调用
+    void stop() {
+        if (!running_.exchange(false)) return;
+        exporter_.join();
+        drain();
+        write_footer();
+        out_.close();
+    }
+    
+    // 已写入文件的记录数
+    size_t exported() const {
+        return exported_.load(std::memory_order_relaxed);
+    }
+    
+    // 因跟踪环满而丢弃的记录数
+    size_t dropped() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t total = 0;
+        for (const auto& state : states_) {
+            total += state->dropped.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+    
+    double ticks_per_us() const {
+        return ticks_per_us_;
+    }
+};
+
+// 被跟踪队列的深度和最大在途消息数
+template<typename T, size_t Size, typename Stats, typename Write, typename Prefetch>
+size_t trace_depth(const SPSCLockFreeQueue<T, Size, Stats, Write, Prefetch>& queue) {
+    return queue.size();
+}
+
+template<typename T, size_t Size, typename Stats, typename Write, typename Prefetch>
+size_t trace_max_in_flight(const SPSCLockFreeQueue<T, Size, Stats, Write, Prefetch>&) {
+    return Size;
+}
+
+template<typename T>
+size_t trace_depth(const DoubleBufferSPSC<T>& queue) {
+    return queue.write_buffer_size() + queue.read_buffer_remaining();
+}
+
+template<typename T>
+size_t trace_max_in_flight(const DoubleBufferSPSC<T>& queue) {
+    return 2 * queue.capacity();
+}
+
+// 为SPSCLockFreeQueue或DoubleBufferSPSC加上1/N采样跟踪，其余接口（swap_buffers等）原样继承
+// 生产者和消费者各自对成功的操作倒数计数，FIFO保证双方在同一条消息上命中采样；
+// 未命中时入队和出队各只多一次计数器比较，这个分支几乎总被正确预测。
+// 批量接口按元素个数推进倒数计数，与逐个操作混用时采样点仍然一致
+template<typename Queue>
+class TracedQueue : public Queue {
+private:
+    // 生产者写、消费者读的入队时间戳，经由队列自身的release/acquire同步；
+    // 槽数大于最大在途采样数，消费者读取前不会被生产者覆盖
+    std::vector<uint64_t> enqueue_ticks_;
+    std::vector<uint32_t> enqueue_depths_;
+    size_t stamp_mask_ = 0;
+    size_t sample_every_;
+    
+    QueueTracer::Ring* ring_;
+    std::atomic<size_t>* dropped_;
+    uint32_t queue_id_ = 0;
+    
+    alignas(64) size_t produce_countdown_;   // 只由生产者访问
+    size_t produce_samples_ = 0;
+    
+    alignas(64) size_t consume_countdown_;   // 只由消费者访问
+    size_t consume_samples_ = 0;
+    
+    template<typename U>
+    bool enqueue_sampled(U&& item) {
+        const size_t slot = produce_samples_ & stamp_mask_;
+        enqueue_depths_[slot] = static_cast<uint32_t>(trace_depth(static_cast<const Queue&>(*this)) + 1);
+        enqueue_ticks_[slot] = read_trace_clock();
+        if (!Queue::enqueue(std::forward<U>(item))) {
+            return false;  // 下次成功入队时重新打点
+        }
+        ++produce_samples_;
+        produce_countdown_ = sample_every_;
+        return true;
+    }
+    
+    void record_dequeue() {
+        const size_t slot = consume_samples_ & stamp_mask_;
+        TraceRecord record;
+        record.queue_id = queue_id_;
+        record.depth = enqueue_depths_[slot];
+        record.seq = consume_samples_ * sample_every_ + sample_every_ - 1;
+        record.enqueue_tick = enqueue_ticks_[slot];
+        record.dequeue_tick = read_trace_clock();
+        if (!ring_->enqueue(record)) {
+            dropped_->store(dropped_->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        ++consume_samples_;
+        consume_countdown_ = sample_every_;
+    }
+
+public:
+    // sample_every为0时不采样；其余参数原样传给被跟踪队列的构造函数
+    template<typename... Args>
+    TracedQueue(QueueTracer& tracer, const std::string& name, size_t sample_every, Args&&... args)
+        : Queue(std::forward<Args>(args)...),
+          sample_every_(sample_every),
+          produce_countdown_(sample_every ? sample_every : SIZE_MAX),
+          consume_countdown_(sample_every ? sample_every : SIZE_MAX) {
+        ring_ = tracer.register_queue(name, queue_id_, dropped_);
+        
+        size_t in_flight_samples = sample_every ? trace_max_in_flight(static_cast<const Queue&>(*this)) / sample_every : 0;
+        size_t slots = 1;
+        while (slots < in_flight_samples + 2) slots <<= 1;
+        enqueue_ticks_.assign(slots, 0);
+        enqueue_depths_.assign(slots, 0);
+        stamp_mask_ = slots - 1;
+    }
+    
+    // 生产者端：入队操作
+    template<typename U>
+    bool enqueue(U&& item) {
+        if (produce_countdown_ != 1) {
+            if (!Queue::enqueue(std::forward<U>(item))) {
+                return false;
+            }
+            --produce_countdown_;
+            return true;
+        }
+        return enqueue_sampled(std::forward<U>(item));
+    }
+    
+    // 消费者端：出队操作
+    template<typename U>
+    bool dequeue(U& item) {
+        if (!Queue::dequeue(item)) {
+            return false;
+        }
+        if (--consume_countdown_ == 0) {
+            record_dequeue();
+        }
+        return true;
+    }
+    
+    // 生产者端：批量入队，返回实际入队数量；在采样点处拆开，采样的那条单独打点入队
+    size_t enqueue_bulk(const typename Queue::value_type* items, size_t count) {
+        size_t done = 0;
+        while (done < count) {
+            const size_t before_sample = std::min(count - done, produce_countdown_ - 1);
+            const size_t pushed = before_sample ? Queue::enqueue_bulk(items + done, before_sample) : 0;
+            produce_countdown_ -= pushed;
+            done += pushed;
+            if (pushed < before_sample || done == count || !enqueue_sampled(items[done])) {
+                break;
+            }
+            ++done;
+        }
+        return done;
+    }
+    
+    // 消费者端：批量出队，返回实际出队数量；批内每个采样点各记录一条
+    size_t dequeue_bulk(typename Queue::value_type* items, size_t max_count) {
+        const size_t n = Queue::dequeue_bulk(items, max_count);
+        size_t remaining = n;
+        while (remaining >= consume_countdown_) {
+            remaining -= consume_countdown_;
+            record_dequeue();
+        }
+        consume_countdown_ -= remaining;
+        return n;
+    }
+};
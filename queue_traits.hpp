@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "spsc_lockfree_queue.hpp"
+#include "mpmc_bounded_queue.hpp"
+#include "locked_queue.hpp"
+#include "double_buffer_spsc.hpp"
+#include "queue.hpp"
+
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+#include <concepts>
+#endif
+
+// 队列的统一访问接口和静态属性，泛型代码（如benchmark.cpp）只通过QueueTraits操作队列：
+//
+//   try_push(q, item)                  非阻塞入队
+//   try_pop(q, item)                   非阻塞出队
+//   try_push_bulk(q, items, count)     批量入队，返回实际数量
+//   try_pop_bulk(q, items, max_count)  批量出队，返回实际数量
+//   capacity(q) / size_approx(q)
+//
+//   is_spsc          只允许一个生产者和一个消费者
+//   is_bounded       容量固定，满时入队失败
+//   is_blocking      支持在条件变量上阻塞出队
+//   preserves_fifo   出队顺序与入队顺序一致
+//   has_bulk         批量接口是原生实现（整批一次同步），否则逐个循环
+//
+// 默认实现适配enqueue/dequeue/size/capacity风格的队列，新队列只要提供这些成员和value_type
+// 就能直接接入；属性与默认值不同时再特化QueueTraits
+
+namespace queue_traits_detail {
+
+template<typename Q, typename = void>
+struct has_basic_ops : std::false_type {};
+
+template<typename Q>
+struct has_basic_ops<Q, std::void_t<
+    typename Q::value_type,
+    decltype(std::declval<Q&>().enqueue(std::declval<const typename Q::value_type&>())),
+    decltype(std::declval<Q&>().dequeue(std::declval<typename Q::value_type&>())),
+    decltype(std::declval<const Q&>().size()),
+    decltype(std::declval<const Q&>().capacity())>>
+    : std::true_type {};
+
+template<typename Q, typename = void>
+struct has_native_bulk : std::false_type {};
+
+template<typename Q>
+struct has_native_bulk<Q, std::void_t<
+    decltype(std::declval<Q&>().enqueue_bulk(std::declval<const typename Q::value_type*>(), size_t{})),
+    decltype(std::declval<Q&>().dequeue_bulk(std::declval<typename Q::value_type*>(), size_t{}))>>
+    : std::true_type {};
+
+}  // namespace queue_traits_detail
+
+// enqueue/dequeue风格队列的操作适配，不具备这些成员的类型得到空的QueueOps
+template<typename Q, typename = void>
+struct QueueOps {};
+
+template<typename Q>
+struct QueueOps<Q, std::enable_if_t<queue_traits_detail::has_basic_ops<Q>::value>> {
+    using value_type = typename Q::value_type;
+    
+    static constexpr bool has_bulk = queue_traits_detail::has_native_bulk<Q>::value;
+    
+    template<typename U>
+    static bool try_push(Q& queue, U&& item) {
+        return queue.enqueue(std::forward<U>(item));
+    }
+    
+    static bool try_pop(Q& queue, value_type& item) {
+        return queue.dequeue(item);
+    }
+    
+    static size_t try_push_bulk(Q& queue, const value_type* items, size_t count) {
+        if constexpr (has_bulk) {
+            return queue.enqueue_bulk(items, count);
+        } else {
+            size_t n = 0;
+            while (n < count && queue.enqueue(items[n])) ++n;
+            return n;
+        }
+    }
+    
+    static size_t try_pop_bulk(Q& queue, value_type* items, size_t max_count) {
+        if constexpr (has_bulk) {
+            return queue.dequeue_bulk(items, max_count);
+        } else {
+            size_t n = 0;
+            while (n < max_count && queue.dequeue(items[n])) ++n;
+            return n;
+        }
+    }
+    
+    static size_t capacity(const Q& queue) {
+        return queue.capacity();
+    }
+    
+    static size_t size_approx(const Q& queue) {
+        return queue.size();
+    }
+};
+
+// 默认属性：多生产者多消费者、有界、非阻塞、保持FIFO
+template<typename Q>
+struct QueueTraits : QueueOps<Q> {
+    static constexpr bool is_spsc = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = false;
+    static constexpr bool preserves_fifo = true;
+};
+
+template<typename T, size_t Size, typename Stats, typename Write, typename Prefetch>
+struct QueueTraits<SPSCLockFreeQueue<T, Size, Stats, Write, Prefetch>> : QueueOps<SPSCLockFreeQueue<T, Size, Stats, Write, Prefetch>> {
+    static constexpr bool is_spsc = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = false;
+    static constexpr bool preserves_fifo = true;
+};
+
+template<typename T, bool MultiProducer, bool MultiConsumer>
+struct QueueTraits<MPMCBoundedQueue<T, MultiProducer, MultiConsumer>>
+    : QueueOps<MPMCBoundedQueue<T, MultiProducer, MultiConsumer>> {
+    static constexpr bool is_spsc = !MultiProducer && !MultiConsumer;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = false;
+    static constexpr bool preserves_fifo = true;
+};
+
+template<typename T>
+struct QueueTraits<LockedQueue<T>> : QueueOps<LockedQueue<T>> {
+    static constexpr bool is_spsc = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = true;
+    static constexpr bool preserves_fifo = true;
+};
+
+// 写入的数据在swap_buffers()之前对消费者不可见，泛型代码需要自行切换缓冲区
+template<typename T>
+struct QueueTraits<DoubleBufferSPSC<T>> : QueueOps<DoubleBufferSPSC<T>> {
+    static constexpr bool is_spsc = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = false;
+    static constexpr bool preserves_fifo = true;
+};
+
+// eventfd_queue.hpp只在Linux上可用，这里只需声明
+template<typename T, size_t Size, typename Stats>
+class EventfdSPSCQueue;
+
+template<typename T, size_t Size, typename Stats>
+struct QueueTraits<EventfdSPSCQueue<T, Size, Stats>> : QueueOps<EventfdSPSCQueue<T, Size, Stats>> {
+    static constexpr bool is_spsc = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = false;
+    static constexpr bool preserves_fifo = true;
+};
+
+// 策略队列：属性由策略决定，操作直接转发
+template<typename T, typename Producers, typename Consumers, size_t Capacity,
+         typename Storage, typename Wait, typename Stats>
+struct QueueTraits<Queue<T, Producers, Consumers, Capacity, Storage, Wait, Stats>> {
+    using queue_type = Queue<T, Producers, Consumers, Capacity, Storage, Wait, Stats>;
+    using value_type = T;
+    
+    static constexpr bool is_spsc = queue_type::kSingleProducer && queue_type::kSingleConsumer;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_blocking = queue_type::kBlocking;
+    static constexpr bool preserves_fifo = true;
+    static constexpr bool has_bulk = queue_type::has_bulk;
+    
+    template<typename U>
+    static bool try_push(queue_type& queue, U&& item) {
+        return queue.try_push(std::forward<U>(item));
+    }
+    
+    static bool try_pop(queue_type& queue, T& item) {
+        return queue.try_pop(item);
+    }
+    
+    static size_t try_push_bulk(queue_type& queue, const T* items, size_t count) {
+        return queue.try_push_bulk(items, count);
+    }
+    
+    static size_t try_pop_bulk(queue_type& queue, T* items, size_t max_count) {
+        return queue.try_pop_bulk(items, max_count);
+    }
+    
+    static size_t capacity(const queue_type& queue) {
+        return queue.capacity();
+    }
+    
+    static size_t size_approx(const queue_type& queue) {
+        return queue.size();
+    }
+};
+
+// C++17下用检测惯用法判断Q是否满足统一接口
+namespace queue_traits_detail {
+
+template<typename Q, typename = void>
+struct is_concurrent_queue : std::false_type {};
+
+template<typename Q>
+struct is_concurrent_queue<Q, std::void_t<
+    typename QueueTraits<Q>::value_type,
+    decltype(QueueTraits<Q>::is_spsc),
+    decltype(QueueTraits<Q>::is_bounded),
+    decltype(QueueTraits<Q>::is_blocking),
+    decltype(QueueTraits<Q>::preserves_fifo),
+    decltype(QueueTraits<Q>::has_bulk),
+    decltype(QueueTraits<Q>::try_push(std::declval<Q&>(), std::declval<const typename QueueTraits<Q>::value_type&>())),
+    decltype(QueueTraits<Q>::try_pop(std::declval<Q&>(), std::declval<typename QueueTraits<Q>::value_type&>())),
+    decltype(QueueTraits<Q>::try_push_bulk(std::declval<Q&>(), std::declval<const typename QueueTraits<Q>::value_type*>(), size_t{})),
+    decltype(QueueTraits<Q>::try_pop_bulk(std::declval<Q&>(), std::declval<typename QueueTraits<Q>::value_type*>(), size_t{})),
+    decltype(QueueTraits<Q>::capacity(std::declval<const Q&>())),
+    decltype(QueueTraits<Q>::size_approx(std::declval<const Q&>()))>>
+    : std::true_type {};
+
+}  // namespace queue_traits_detail
+
+template<typename Q>
+constexpr bool is_concurrent_queue_v = queue_traits_detail::is_concurrent_queue<Q>::value;
+
+// C++20下同样的要求写成概念，可直接约束模板参数
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+template<typename Q>
+concept ConcurrentQueue = requires(Q& queue, const Q& const_queue,
+                                   typename QueueTraits<Q>::value_type& item,
+                                   typename QueueTraits<Q>::value_type* items,
+                                   const typename QueueTraits<Q>::value_type* const_items, size_t count) {
+    { QueueTraits<Q>::is_spsc } -> std::convertible_to<bool>;
+    { QueueTraits<Q>::is_bounded } -> std::convertible_to<bool>;
+    { QueueTraits<Q>::is_blocking } -> std::convertible_to<bool>;
+    { QueueTraits<Q>::preserves_fifo } -> std::convertible_to<bool>;
+    { QueueTraits<Q>::has_bulk } -> std::convertible_to<bool>;
+    { QueueTraits<Q>::try_push(queue, std::as_const(item)) } -> std::same_as<bool>;
+    { QueueTraits<Q>::try_pop(queue, item) } -> std::same_as<bool>;
+    { QueueTraits<Q>::try_push_bulk(queue, const_items, count) } -> std::same_as<size_t>;
+    { QueueTraits<Q>::try_pop_bulk(queue, items, count) } -> std::same_as<size_t>;
+    { QueueTraits<Q>::capacity(const_queue) } -> std::same_as<size_t>;
+    { QueueTraits<Q>::size_approx(const_queue) } -> std::same_as<size_t>;
+};
+#endif
@@ -0,0 +1,306 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "replay_reader.hpp"
+#include "spsc_lockfree_queue.hpp"
+#include "bench_util.hpp"
+
+// 录制文件回放基准：先生成一个录制文件（记录长度在[min-size, max-size]内随机，
+// 时间戳间隔平均gap-ns），再测
+//   scan      只用CaptureFile遍历记录并读取数据首尾8字节，测读取端本身的上限
+//   replay    CaptureReplayer推入SPSCLockFreeQueue<CaptureRecord>，消费者线程取出记录并校验序号
+// speed为0时全速回放，大于0时按时间戳以该倍速回放并统计迟到情况
+
+struct ReplayBenchConfig {
+    std::string path = "/tmp/lfq_replay_bench.capture";
+    size_t file_mb = 256;
+    uint32_t min_size = 32;
+    uint32_t max_size = 256;
+    uint64_t gap_ns = 1000;
+    std::vector<double> speeds{0.0, 10.0};
+    int repetitions = 3;
+    bool cold = false;  // 每次运行前丢弃文件的页缓存
+    bool keep = false;  // 结束后保留录制文件
+};
+
+struct ReplayBenchResult {
+    std::string mode;
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    double elapsed_s = 0.0;
+    uint64_t full_spins = 0;
+    uint64_t late_records = 0;
+    int64_t max_lateness_ns = 0;
+    bool valid = true;
+};
+
+// 生成录制文件：每条记录数据的前8字节为序号，其余为填充
+bool generate_capture(const ReplayBenchConfig& config, uint64_t& records, std::string& error) {
+    CaptureWriter writer(config.path);
+    if (!writer.available()) {
+        error = writer.error();
+        return false;
+    }
+    std::vector<unsigned char> payload(config.max_size, 0x5a);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    uint64_t timestamp = 1000000000ull;
+    const uint64_t target = static_cast<uint64_t>(config.file_mb) << 20;
+    records = 0;
+    while (writer.bytes() < target) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const uint32_t size = config.min_size + static_cast<uint32_t>(state % (config.max_size - config.min_size + 1));
+        std::memcpy(payload.data(), &records, sizeof(records));
+        if (!writer.write(timestamp, payload.data(), size)) {
+            error = writer.error();
+            return false;
+        }
+        timestamp += state % (2 * config.gap_ns + 1);  // 间隔在[0, 2*gap]内均匀分布
+        ++records;
+    }
+    return true;
+}
+
+// 把录制文件的页从页缓存中丢弃，下一次读取走磁盘（tmpfs上无效）
+void drop_page_cache(const std::string& path) {
+#ifdef __linux__
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+inline uint64_t touch(const CaptureRecord& record) {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    std::memcpy(&head, record.data, sizeof(head));
+    std::memcpy(&tail, static_cast<const unsigned char*>(record.data) + record.size - sizeof(tail), sizeof(tail));
+    return head ^ tail;
+}
+
+ReplayBenchResult run_scan(const ReplayBenchConfig& config, uint64_t expected_records, std::string& error) {
+    ReplayBenchResult result;
+    result.mode = "scan";
+    CaptureFile file(config.path);
+    if (!file.available()) {
+        error = file.error();
+        result.valid = false;
+        return result;
+    }
+    const int64_t begin = bench_util::steady_now_ns();
+    CaptureRecord record;
+    uint64_t checksum = 0;
+    while (file.next(record)) {
+        checksum += touch(record);
+        ++result.records;
+        result.bytes += record.size;
+    }
+    result.elapsed_s = (bench_util::steady_now_ns() - begin) / 1e9;
+    result.valid = result.records == expected_records && checksum != 0;
+    return result;
+}
+
+ReplayBenchResult run_replay(const ReplayBenchConfig& config, double speed, uint64_t expected_records,
+                             std::string& error) {
+    using Queue = SPSCLockFreeQueue<CaptureRecord, 4096>;
+    ReplayBenchResult result;
+    std::ostringstream mode;
+    if (speed > 0.0) {
+        mode << "replay x" << speed;
+    } else {
+        mode << "replay max";
+    }
+    result.mode = mode.str();
+    
+    ReplayOptions options;
+    options.speed = speed;
+    CaptureReplayer replayer({config.path}, options);
+    if (!replayer.available()) {
+        error = replayer.error();
+        result.valid = false;
+        return result;
+    }
+    
+    auto queue = std::make_unique<Queue>();
+    std::atomic<bool> stop{false};
+    std::atomic<bool> consumer_valid{true};
+    std::thread consumer([&]() {
+        CaptureRecord records[64];
+        uint64_t expected = 0;
+        uint64_t checksum = 0;
+        while (expected < expected_records) {
+            const size_t n = queue->dequeue_bulk(records, 64);
+            if (n == 0) {
+                if (stop.load(std::memory_order_relaxed)) break;
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t sequence;
+                std::memcpy(&sequence, records[i].data, sizeof(sequence));
+                if (sequence != expected) {
+                    consumer_valid.store(false, std::memory_order_relaxed);
+                }
+                checksum += touch(records[i]);
+                ++expected;
+            }
+        }
+        if (expected != expected_records || checksum == 0) {
+            consumer_valid.store(false, std::memory_order_relaxed);
+        }
+    });
+    
+    const int64_t begin = bench_util::steady_now_ns();
+    ReplayStats stats = replayer.replay(*queue, &stop);
+    stop.store(true, std::memory_order_relaxed);
+    consumer.join();
+    // 计到消费者取完最后一条为止
+    result.elapsed_s = (bench_util::steady_now_ns() - begin) / 1e9;
+    result.records = stats.records;
+    result.bytes = stats.bytes;
+    result.full_spins = stats.full_spins;
+    result.late_records = stats.late_records;
+    result.max_lateness_ns = stats.max_lateness_ns;
+    result.valid = consumer_valid.load(std::memory_order_relaxed) && stats.records == expected_records;
+    return result;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --file=PATH          录制文件路径（默认/tmp/lfq_replay_bench.capture，运行前重新生成）\n"
+              << "  --mb=N               录制文件大小（默认256）\n"
+              << "  --min-size=N         记录最小字节数，至少8（默认32）\n"
+              << "  --max-size=N         记录最大字节数（默认256）\n"
+              << "  --gap-ns=N           相邻记录时间戳的平均间隔（默认1000）\n"
+              << "  --speed=LIST         回放倍速列表，0为全速（默认0,10）\n"
+              << "  --repetitions=N      每项重复次数，取最好的一次（默认3）\n"
+              << "  --cold               每次运行前丢弃录制文件的页缓存\n"
+              << "  --keep               结束后保留录制文件\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+void print_result(const ReplayBenchResult& r) {
+    std::ostringstream late;
+    if (r.mode.rfind("replay x", 0) == 0) {
+        late << r.late_records << "/" << std::fixed << std::setprecision(1) << r.max_lateness_ns / 1e3;
+    } else {
+        late << "-";
+    }
+    std::cout << std::setw(14) << r.mode
+              << std::setw(12) << r.records
+              << std::setw(10) << std::fixed << std::setprecision(2) << r.bytes / r.elapsed_s / 1e9
+              << std::setw(14) << std::setprecision(2) << r.records / r.elapsed_s / 1e6
+              << std::setw(12) << std::setprecision(1) << r.elapsed_s * 1e3
+              << std::setw(12) << r.full_spins
+              << late.str() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ReplayBenchConfig config;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--file") {
+            config.path = value;
+        } else if (key == "--mb") {
+            config.file_mb = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--min-size") {
+            config.min_size = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--max-size") {
+            config.max_size = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "--gap-ns") {
+            config.gap_ns = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "--speed") {
+            config.speeds = bench_util::parse_double_list(value);
+        } else if (key == "--repetitions") {
+            config.repetitions = std::atoi(value.c_str());
+        } else if (key == "--cold") {
+            config.cold = true;
+        } else if (key == "--keep") {
+            config.keep = true;
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (config.file_mb == 0 || config.min_size < 8 || config.max_size < config.min_size ||
+        config.repetitions <= 0 || config.speeds.empty() ||
+        std::any_of(config.speeds.begin(), config.speeds.end(), [](double s) { return s < 0.0; })) {
+        std::cerr << "参数超出范围（文件大小和重复次数为正，记录至少8字节且最小不超过最大，倍速不为负）" << std::endl;
+        return 1;
+    }
+    
+    uint64_t records = 0;
+    std::string error;
+    const int64_t generate_begin = bench_util::steady_now_ns();
+    if (!generate_capture(config, records, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "录制文件回放基准（" << config.path << "，" << config.file_mb << "MB，" << records << "条记录，"
+              << config.min_size << "-" << config.max_size << "字节，生成用时"
+              << std::fixed << std::setprecision(0) << (bench_util::steady_now_ns() - generate_begin) / 1e6 << "ms"
+              << (config.cold ? "，冷缓存" : "") << "）" << std::endl;
+    bench_util::print_rule(90);
+    bench_util::print_header({{"模式", 14}, {"记录数", 12}, {"GB/s", 10}, {"M msgs/s", 14}, {"耗时(ms)", 12}, {"队列满次数", 12},
+                              {"迟到数/最大迟到(us)", 0}});
+    bench_util::print_rule(90, '-');
+    
+    // 按吞吐量取最好的一次；按节奏回放的耗时由时间戳决定，同样取最好的一次
+    auto best_of = [&](auto&& run) {
+        ReplayBenchResult best;
+        for (int rep = 0; rep < config.repetitions; ++rep) {
+            if (config.cold) drop_page_cache(config.path);
+            ReplayBenchResult r = run();
+            if (!r.valid) return r;
+            if (rep == 0 || r.elapsed_s < best.elapsed_s) best = r;
+        }
+        return best;
+    };
+    
+    int exit_code = 0;
+    auto report = [&](const ReplayBenchResult& r) {
+        if (!r.valid) {
+            std::cerr << r.mode << ": " << (error.empty() ? "记录数或序号错误" : error) << std::endl;
+            exit_code = 1;
+            return;
+        }
+        print_result(r);
+    };
+    
+    report(best_of([&]() { return run_scan(config, records, error); }));
+    for (double speed : config.speeds) {
+        report(best_of([&]() { return run_replay(config, speed, records, error); }));
+    }
+    bench_util::print_rule(90);
+    
+    if (!config.keep) {
+        std::remove(config.path.c_str());
+    }
+    return exit_code;
+}
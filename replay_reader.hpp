@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 录制文件回放：把按长度前缀存储的录制文件顺序映射到内存，不拷贝地逐条取出记录，
+// 推入SPSCLockFreeQueue，可以全速回放，也可以按录制时间戳以指定倍速回放
+//
+// 文件格式：连续的 [4字节长度 | 4字节保留 | 8字节时间戳(ns) | 数据，补齐到8字节]
+// 记录之间没有分隔，文件末尾不足一个记录头的部分忽略
+
+// 一条记录的视图，data指向映射区，在CaptureReplayer/CaptureFile销毁前有效
+struct CaptureRecord {
+    uint64_t timestamp_ns = 0;
+    const void* data = nullptr;
+    uint32_t size = 0;
+};
+
+namespace capture_detail {
+
+constexpr size_t kRecordHeaderSize = 16;
+
+inline size_t align8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+}  // namespace capture_detail
+
+// 写录制文件（生成测试数据或把实时流量存下来供以后回放）
+class CaptureWriter {
+private:
+    std::FILE* file_ = nullptr;
+    std::string error_;
+    uint64_t bytes_ = 0;
+
+public:
+    explicit CaptureWriter(const std::string& path) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            error_ = "创建" + path + "失败: " + strerror(errno);
+        }
+    }
+    
+    ~CaptureWriter() {
+        if (file_ != nullptr) std::fclose(file_);
+    }
+    
+    // 禁止拷贝和移动
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+    CaptureWriter(CaptureWriter&&) = delete;
+    CaptureWriter& operator=(CaptureWriter&&) = delete;
+    
+    bool available() const {
+        return file_ != nullptr;
+    }
+    
+    const std::string& error() const {
+        return error_;
+    }
+    
+    bool write(uint64_t timestamp_ns, const void* data, uint32_t size) {
+        if (file_ == nullptr) return false;
+        unsigned char header[capture_detail::kRecordHeaderSize] = {};
+        std::memcpy(header, &size, sizeof(size));
+        std::memcpy(header + 8, &timestamp_ns, sizeof(timestamp_ns));
+        static const unsigned char padding[8] = {};
+        const size_t pad = capture_detail::align8(size) - size;
+        if (std::fwrite(header, sizeof(header), 1, file_) != 1 ||
+            (size > 0 && std::fwrite(data, size, 1, file_) != 1) ||
+            (pad > 0 && std::fwrite(padding, pad, 1, file_) != 1)) {
+            error_ = std::string("写入失败: ") + strerror(errno);
+            return false;
+        }
+        bytes_ += sizeof(header) + size + pad;
+        return true;
+    }
+    
+    uint64_t bytes() const {
+        return bytes_;
+    }
+};
+
+// 只读映射的录制文件，顺序遍历
+//
+// 映射时设置MADV_SEQUENTIAL让内核加大预读并尽快回收已读过的页；遍历时在当前位置之前
+// 保持readahead_bytes的MADV_WILLNEED窗口，让磁盘读取与处理重叠
+class CaptureFile {
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+    std::string error_;
+    
+    size_t pos_ = 0;
+    size_t advised_until_ = 0;  // 已发出WILLNEED的位置
+    size_t readahead_bytes_;
+    
+    void advise_ahead() {
+#ifdef __linux__
+        if (readahead_bytes_ == 0 || advised_until_ >= size_ || pos_ + readahead_bytes_ / 2 < advised_until_) {
+            return;  // 窗口还剩一半以上时不再发系统调用
+        }
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t begin = advised_until_ & ~(page - 1);
+        const size_t end = std::min(size_, pos_ + readahead_bytes_);
+        if (end > begin) {
+            ::madvise(const_cast<unsigned char*>(data_) + begin, end - begin, MADV_WILLNEED);
+        }
+        advised_until_ = end;
+#endif
+    }
+
+public:
+    explicit CaptureFile(const std::string& path, size_t readahead_bytes = 8u << 20)
+        : readahead_bytes_(readahead_bytes) {
+#ifdef __linux__
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            error_ = "打开" + path + "失败: " + strerror(errno);
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            error_ = "读取" + path + "大小失败: " + strerror(errno);
+            return;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            return;  // 空文件：没有记录
+        }
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            error_ = "映射" + path + "失败: " + strerror(errno);
+            size_ = 0;
+            return;
+        }
+        data_ = static_cast<const unsigned char*>(p);
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        advise_ahead();
+#else
+        (void)path;
+        error_ = "当前平台不支持录制文件回放";
+#endif
+    }
+    
+    ~CaptureFile() {
+#ifdef __linux__
+        if (data_ != nullptr) ::munmap(const_cast<unsigned char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+    
+    // 禁止拷贝和移动（记录视图指向本对象的映射）
+    CaptureFile(const CaptureFile&) = delete;
+    CaptureFile& operator=(const CaptureFile&) = delete;
+    CaptureFile(CaptureFile&&) = delete;
+    CaptureFile& operator=(CaptureFile&&) = delete;
+    
+    bool available() const {
+        return error_.empty();
+    }
+    
+    const std::string& error() const {
+        return error_;
+    }
+    
+    // 取下一条记录；到达文件末尾或遇到截断的记录时返回false
+    bool next(CaptureRecord& record) {
+        using namespace capture_detail;
+        if (pos_ + kRecordHeaderSize > size_) {
+            return false;
+        }
+        uint32_t length;
+        std::memcpy(&length, data_ + pos_, sizeof(length));
+        const size_t total = kRecordHeaderSize + align8(length);
+        if (total > size_ - pos_ && kRecordHeaderSize + length > size_ - pos_) {
+            return false;  // 最后一条记录不完整（录制时被中断）
+        }
+        std::memcpy(&record.timestamp_ns, data_ + pos_ + 8, sizeof(record.timestamp_ns));
+        record.data = data_ + pos_ + kRecordHeaderSize;
+        record.size = length;
+        pos_ = std::min(size_, pos_ + total);
+        advise_ahead();
+        return true;
+    }
+    
+    // 回到文件开头
+    void rewind() {
+        pos_ = 0;
+        advised_until_ = 0;
+        advise_ahead();
+    }
+    
+    size_t size() const {
+        return size_;
+    }
+    
+    size_t position() const {
+        return pos_;
+    }
+};
+
+struct ReplayOptions {
+    double speed = 0.0;                   // 0表示全速；1.0按录制节奏，10.0为10倍速
+    size_t readahead_bytes = 8u << 20;    // WILLNEED窗口大小，0表示只依赖MADV_SEQUENTIAL
+};
+
+struct ReplayStats {
+    uint64_t records = 0;
+    uint64_t bytes = 0;             // 记录数据的字节数（不含记录头）
+    uint64_t file_bytes = 0;        // 遍历过的文件字节数
+    uint64_t full_spins = 0;        // 队列满时的重试次数
+    uint64_t late_records = 0;      // 按节奏回放时晚于计划时间超过10us的记录数
+    int64_t max_lateness_ns = 0;
+    double elapsed_s = 0.0;
+};
+
+// 按顺序回放一组录制文件。所有文件在对象生存期内保持映射，消费者可以持有记录视图
+// 直到回放结束后销毁本对象
+class CaptureReplayer {
+private:
+    std::vector<std::unique_ptr<CaptureFile>> files_;
+    ReplayOptions options_;
+    std::string error_;
+    
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    // 等到计划时间；相差较远时睡眠，最后一段自旋
+    static void wait_until(int64_t deadline_ns) {
+        while (true) {
+            const int64_t remaining = deadline_ns - now_ns();
+            if (remaining <= 0) return;
+            if (remaining > 200000) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - 100000));
+            }
+        }
+    }
+
+public:
+    explicit CaptureReplayer(const std::vector<std::string>& paths, ReplayOptions options = {})
+        : options_(options) {
+        for (const auto& path : paths) {
+            files_.push_back(std::make_unique<CaptureFile>(path, options_.readahead_bytes));
+            if (!files_.back()->available()) {
+                error_ = files_.back()->error();
+                break;
+            }
+        }
+    }
+    
+    // 禁止拷贝和移动
+    CaptureReplayer(const CaptureReplayer&) = delete;
+    CaptureReplayer& operator=(const CaptureReplayer&) = delete;
+    CaptureReplayer(CaptureReplayer&&) = delete;
+    CaptureReplayer& operator=(CaptureReplayer&&) = delete;
+    
+    bool available() const {
+        return error_.empty();
+    }
+    
+    const std::string& error() const {
+        return error_;
+    }
+    
+    // 把全部记录推入queue（元素类型为CaptureRecord的单生产者队列，需要enqueue_bulk），
+    // 队列满时让出CPU后重试；stop被置位时提前返回。可以重复调用，每次从头回放
+    //
+    // 记录攒满kBatch条再用enqueue_bulk一次发布，每批只有一次tail的release写；按节奏回放时
+    // 遇到需要等待的记录先把已到点的发出去，所以只有落后于计划时才会攒批
+    template<typename Queue>
+    ReplayStats replay(Queue& queue, const std::atomic<bool>* stop = nullptr) {
+        constexpr size_t kBatch = 64;
+        ReplayStats stats;
+        const bool paced = options_.speed > 0.0;
+        const int64_t start_ns = now_ns();
+        bool have_first = false;
+        uint64_t first_timestamp = 0;
+        
+        CaptureRecord batch[kBatch];
+        size_t pending = 0;
+        // 返回false表示被stop打断
+        auto flush = [&]() {
+            size_t done = 0;
+            while (done < pending) {
+                const size_t n = queue.enqueue_bulk(batch + done, pending - done);
+                if (n == 0) {
+                    if (stop != nullptr && stop->load(std::memory_order_relaxed)) return false;
+                    ++stats.full_spins;
+                    std::this_thread::yield();  // 消费者跟不上时让出CPU，核数不足时不至于空转整个时间片
+                }
+                for (size_t i = done; i < done + n; ++i) {
+                    stats.bytes += batch[i].size;
+                }
+                stats.records += n;
+                done += n;
+            }
+            pending = 0;
+            return true;
+        };
+        
+        for (auto& file : files_) {
+            file->rewind();
+            while (file->next(batch[pending])) {
+                const CaptureRecord& record = batch[pending];
+                if (paced) {
+                    if (!have_first) {
+                        first_timestamp = record.timestamp_ns;
+                        have_first = true;
+                    }
+                    // 时间戳回退（录制端时钟调整）的记录立即发出
+                    const uint64_t delta = record.timestamp_ns > first_timestamp ? record.timestamp_ns - first_timestamp : 0;
+                    const int64_t deadline = start_ns + static_cast<int64_t>(static_cast<double>(delta) / options_.speed);
+                    const int64_t now = now_ns();
+                    if (deadline > now) {
+                        // 要等待时先发布已经到点的记录；落后时到点的记录继续攒批
+                        if (pending > 0) {
+                            const CaptureRecord current = record;
+                            if (!flush()) {
+                                stats.elapsed_s = (now_ns() - start_ns) / 1e9;
+                                return stats;
+                            }
+                            batch[0] = current;
+                        }
+                        wait_until(deadline);
+                    } else {
+                        const int64_t lateness = now - deadline;
+                        if (lateness > 10000) ++stats.late_records;
+                        if (lateness > stats.max_lateness_ns) stats.max_lateness_ns = lateness;
+                    }
+                }
+                if (++pending == kBatch && !flush()) {
+                    stats.elapsed_s = (now_ns() - start_ns) / 1e9;
+                    return stats;
+                }
+            }
+            stats.file_bytes += file->position();
+        }
+        flush();
+        stats.elapsed_s = (now_ns() - start_ns) / 1e9;
+        return stats;
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// 序号校验（seqlock）的公共部分：序号为奇数表示写者正在写，读者读数据前后两次读序号，
+// 相同且为偶数才算读到完整的数据。ConflatingQueue等的槽位都用这里的write/try_read/read读写
+//
+// 只依赖<atomic>，不引入queue.hpp的等待策略
+
+namespace seqlock_detail {
+
+// 读者等写者写完时的自旋提示
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// 写者端：先把序号写为odd（奇数，表示正在写），调用write_value写数据，再写为odd + 1
+template<typename Seq, typename Write>
+inline void write(std::atomic<Seq>& sequence, Seq odd, Write&& write_value) {
+    sequence.store(odd, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);  // 奇数序号先于数据可见
+    write_value();
+    sequence.store(odd + 1, std::memory_order_release);
+}
+
+// 读者端的一次尝试：before为调用方用acquire读到、已确认数据完整时的序号。
+// 调用read_value拷贝数据后再读一次序号，未变时返回true，否则拷贝到的数据可能被写者打断
+template<typename Seq, typename Read>
+inline bool try_read(const std::atomic<Seq>& sequence, Seq before, Read&& read_value) {
+    read_value();
+    std::atomic_thread_fence(std::memory_order_acquire);  // 数据读取先于第二次读序号
+    return sequence.load(std::memory_order_relaxed) == before;
+}
+
+// 读者端：重试直到读到完整的数据，返回读到数据时的序号；retries累加被写者打断而重读的次数
+template<typename Seq, typename Read>
+inline Seq read(const std::atomic<Seq>& sequence, Read&& read_value, size_t& retries) {
+    while (true) {
+        const Seq before = sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0 && try_read(sequence, before, read_value)) {
+            return before;
+        }
+        ++retries;
+        cpu_relax();
+    }
+}
+
+}  // namespace seqlock_detail
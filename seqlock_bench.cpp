@@ -0,0 +1,259 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include "seqlock_cell.hpp"
+#include "bench_util.hpp"
+
+// seqlock广播值基准：一个写者以固定频率更新64字节的费率表，N个读者在duration-ms内不停读取，
+// 测读取吞吐量随读者数的变化
+//   shared/separate  SeqLockCell两种布局的load()
+//   poll             SeqLockCell::load_if_changed()，没有更新时只读序号
+//   rwlock           std::shared_mutex保护的同一结构，作为对照
+// 每次读取都校验费率表的各字段属于同一版本
+
+constexpr size_t kTableWords = 8;
+
+// 每个字都由版本号导出，读到不一致的字说明读到了写了一半的值
+struct FeeTable {
+    uint64_t words[kTableWords];
+    
+    static FeeTable make(uint64_t version) {
+        FeeTable t;
+        for (size_t i = 0; i < kTableWords; ++i) {
+            t.words[i] = version * (i + 1);
+        }
+        return t;
+    }
+    
+    bool consistent() const {
+        for (size_t i = 1; i < kTableWords; ++i) {
+            if (words[i] != words[0] * (i + 1)) return false;
+        }
+        return true;
+    }
+};
+
+struct SeqlockBenchConfig {
+    std::vector<size_t> readers;
+    int write_hz = 1000;     // 0表示不更新
+    int duration_ms = 500;
+};
+
+struct SeqlockBenchResult {
+    double total_mops = 0.0;   // 所有读者合计的读取速率
+    double ns_per_read = 0.0;  // 单个读者每次读取的平均耗时
+    uint64_t retries = 0;
+    uint64_t writes = 0;
+    bool valid = true;
+};
+
+// 各方案的读写适配
+template<typename Layout>
+struct SeqlockChannel {
+    SeqLockCell<FeeTable, Layout> cell{FeeTable::make(0)};
+    
+    void write(const FeeTable& t) {
+        cell.store(t);
+    }
+    
+    // 返回重试次数
+    size_t read(FeeTable& t, uint64_t&) {
+        size_t retries;
+        t = cell.load(retries);
+        return retries;
+    }
+};
+
+struct PollChannel {
+    SeqLockCell<FeeTable> cell{FeeTable::make(0)};
+    
+    void write(const FeeTable& t) {
+        cell.store(t);
+    }
+    
+    // version由每个读者自己保存；没有更新时t保持上次读到的值
+    size_t read(FeeTable& t, uint64_t& version) {
+        cell.load_if_changed(t, version);
+        return 0;
+    }
+};
+
+struct RwLockChannel {
+    mutable std::shared_mutex mutex;
+    FeeTable table = FeeTable::make(0);
+    
+    void write(const FeeTable& t) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        table = t;
+    }
+    
+    size_t read(FeeTable& t, uint64_t&) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        t = table;
+        return 0;
+    }
+};
+
+template<typename Channel>
+SeqlockBenchResult run_channel(const SeqlockBenchConfig& config, size_t readers) {
+    auto channel = std::make_unique<Channel>();
+    SeqlockBenchResult result;
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total_reads{0};
+    std::atomic<uint64_t> total_retries{0};
+    std::atomic<int64_t> busy_ns{0};
+    std::atomic<bool> valid{true};
+    
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&]() {
+            while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+            FeeTable t = FeeTable::make(0);
+            uint64_t version = 0;
+            uint64_t reads = 0;
+            uint64_t retries = 0;
+            uint64_t last = 0;
+            const int64_t begin = bench_util::steady_now_ns();
+            while (!stop.load(std::memory_order_relaxed)) {
+                // 每检查一次stop读取64次，摊薄检查开销
+                for (int i = 0; i < 64; ++i) {
+                    retries += channel->read(t, version);
+                    if (!t.consistent() || t.words[0] < last) {
+                        valid.store(false, std::memory_order_relaxed);
+                    }
+                    last = t.words[0];
+                }
+                reads += 64;
+            }
+            busy_ns.fetch_add(bench_util::steady_now_ns() - begin, std::memory_order_relaxed);
+            total_reads.fetch_add(reads, std::memory_order_relaxed);
+            total_retries.fetch_add(retries, std::memory_order_relaxed);
+        });
+    }
+    
+    std::thread writer([&]() {
+        while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        if (config.write_hz <= 0) return;
+        const auto period = std::chrono::nanoseconds(1000000000 / config.write_hz);
+        auto next = std::chrono::steady_clock::now();
+        uint64_t version = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            channel->write(FeeTable::make(++version));
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        result.writes = version;
+    });
+    
+    const int64_t begin = bench_util::steady_now_ns();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(config.duration_ms));
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    for (auto& t : threads) t.join();
+    const int64_t elapsed = bench_util::steady_now_ns() - begin;
+    
+    const uint64_t reads = total_reads.load(std::memory_order_relaxed);
+    result.total_mops = reads * 1e3 / elapsed;
+    // 各读者的运行时间之和除以总读取次数
+    result.ns_per_read = reads == 0 ? 0.0 : static_cast<double>(busy_ns.load(std::memory_order_relaxed)) / reads;
+    result.retries = total_retries.load(std::memory_order_relaxed);
+    result.valid = valid.load(std::memory_order_relaxed);
+    return result;
+}
+
+template<typename Channel>
+bool report(const char* name, const SeqlockBenchConfig& config, size_t readers) {
+    SeqlockBenchResult r = run_channel<Channel>(config, readers);
+    std::cout << std::setw(12) << name
+              << std::setw(8) << readers
+              << std::setw(14) << std::fixed << std::setprecision(1) << r.total_mops
+              << std::setw(14) << std::setprecision(2) << r.ns_per_read
+              << std::setw(12) << r.writes
+              << std::setw(12) << r.retries
+              << (r.valid ? "通过" : "失败") << std::endl;
+    return r.valid;
+}
+
+void print_usage(const char* prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --filter=STR         只运行名称包含STR的方案（shared、separate、poll、rwlock）\n"
+              << "  --readers=LIST       读者线程数列表（默认1,2,4,...直到硬件线程数）\n"
+              << "  --write-hz=N         写者每秒更新次数，0为不更新（默认1000）\n"
+              << "  --duration-ms=N      每项运行时间（默认500）\n"
+              << "  --help               显示此帮助信息" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    SeqlockBenchConfig config;
+    std::string filter;
+    
+    const int parsed = bench_util::parse_args(argc, argv, print_usage, [&](const std::string& key, const std::string& value) {
+        if (key == "--filter") {
+            filter = value;
+        } else if (key == "--readers") {
+            config.readers = bench_util::parse_size_list(value);
+        } else if (key == "--write-hz") {
+            config.write_hz = std::atoi(value.c_str());
+        } else if (key == "--duration-ms") {
+            config.duration_ms = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (parsed >= 0) {
+        return parsed;
+    }
+    if (config.readers.empty()) {
+        const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t n = 1; n < hw; n *= 2) config.readers.push_back(n);
+        config.readers.push_back(hw);
+    }
+    if (config.duration_ms <= 0 || config.write_hz < 0 || config.write_hz > 1000000000 ||
+        std::find(config.readers.begin(), config.readers.end(), size_t(0)) != config.readers.end()) {
+        std::cerr << "参数超出范围（读者数和运行时间为正，更新频率不超过1e9）" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "seqlock广播值基准（" << sizeof(FeeTable) << "字节，写者每秒" << config.write_hz << "次，每项"
+              << config.duration_ms << "ms）" << std::endl;
+    bench_util::print_rule(84);
+    bench_util::print_header({{"方案", 12}, {"读者", 8}, {"合计(M/s)", 14}, {"每次(ns)", 14}, {"更新次数", 12}, {"重试次数", 12},
+                              {"校验", 0}});
+    bench_util::print_rule(84, '-');
+    
+    auto selected = [&](const char* name) {
+        return filter.empty() || std::string(name).find(filter) != std::string::npos;
+    };
+    int exit_code = 0;
+    for (size_t readers : config.readers) {
+        if (selected("shared") && !report<SeqlockChannel<SeqLockSharedLine>>("shared", config, readers)) {
+            exit_code = 1;
+        }
+        if (selected("separate") && !report<SeqlockChannel<SeqLockSeparateLines>>("separate", config, readers)) {
+            exit_code = 1;
+        }
+        if (selected("poll") && !report<PollChannel>("poll", config, readers)) {
+            exit_code = 1;
+        }
+        if (selected("rwlock") && !report<RwLockChannel>("rwlock", config, readers)) {
+            exit_code = 1;
+        }
+    }
+    bench_util::print_rule(84);
+    
+    return exit_code;
+}
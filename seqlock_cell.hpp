@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "seqlock.hpp"
+
+// 单写者多读者的广播值（seqlock）：写者store()时不等待任何读者，读者load()读到被写者
+// 打断的值时重试。适合费率表、风控限额等读多写少的配置和参考数据
+//
+// 序号为奇数表示写者正在写；读者读数据前后两次读序号，相同且为偶数才算读到完整的值。
+// 没有更新时读者只读取共享状态的缓存行，各核的副本一直有效，不产生任何一致性流量；
+// load_if_changed()在序号不变时只读一次序号，不拷贝数据
+//
+// 多个写者须在外部互斥；T须可平凡复制
+
+// 布局策略：序号与数据放在同一缓存行，或各自独占缓存行
+struct SeqLockSharedLine {};     // 小T时读者只需取一个缓存行
+struct SeqLockSeparateLines {};  // 只轮询版本号的读者不触碰数据所在的缓存行
+
+namespace seqlock_detail {
+
+template<typename T, typename Layout>
+struct Storage;
+
+template<typename T>
+struct alignas(64) Storage<T, SeqLockSharedLine> {
+    std::atomic<uint64_t> sequence{0};
+    T value;
+};
+
+template<typename T>
+struct Storage<T, SeqLockSeparateLines> {
+    alignas(64) std::atomic<uint64_t> sequence{0};
+    alignas(64) T value;
+};
+
+}  // namespace seqlock_detail
+
+template<typename T, typename Layout = SeqLockSharedLine>
+class SeqLockCell {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static_assert(std::is_same<Layout, SeqLockSharedLine>::value || std::is_same<Layout, SeqLockSeparateLines>::value,
+                  "Layout must be SeqLockSharedLine or SeqLockSeparateLines");
+
+private:
+    seqlock_detail::Storage<T, Layout> storage_;
+
+public:
+    using value_type = T;
+    
+    explicit SeqLockCell(const T& initial = T{}) {
+        storage_.value = initial;
+    }
+    
+    // 禁止拷贝和移动
+    SeqLockCell(const SeqLockCell&) = delete;
+    SeqLockCell& operator=(const SeqLockCell&) = delete;
+    SeqLockCell(SeqLockCell&&) = delete;
+    SeqLockCell& operator=(SeqLockCell&&) = delete;
+    
+    // 写者端：发布新值，不等待读者
+    void store(const T& value) {
+        const uint64_t seq = storage_.sequence.load(std::memory_order_relaxed);
+        seqlock_detail::write(storage_.sequence, seq + 1, [&] { storage_.value = value; });
+    }
+    
+    // 读者端：读取当前值，retries为被写者打断而重读的次数
+    T load(size_t& retries) const {
+        retries = 0;
+        T result;
+        seqlock_detail::read(storage_.sequence, [&] { result = storage_.value; }, retries);
+        return result;
+    }
+    
+    T load() const {
+        size_t retries;
+        return load(retries);
+    }
+    
+    // 读者端：自version之后有新值时读入value、更新version并返回true；没有变化时只读一次序号
+    bool load_if_changed(T& value, uint64_t& version) const {
+        if (storage_.sequence.load(std::memory_order_acquire) == version) {
+            return false;
+        }
+        size_t retries = 0;
+        version = seqlock_detail::read(storage_.sequence, [&] { value = storage_.value; }, retries);
+        return true;
+    }
+    
+    // 当前版本号（每次store加2，初始为0）
+    uint64_t version() const {
+        return storage_.sequence.load(std::memory_order_acquire);
+    }
+};
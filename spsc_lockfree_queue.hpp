@@ -1,20 +1,164 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
-template<typename T, size_t Size>
+// 队列统计快照，可在监控线程中随时读取（各计数器分别读取，彼此之间不保证一致）
+struct SPSCQueueStatsSnapshot {
+    size_t enqueued = 0;          // 成功入队次数
+    size_t dequeued = 0;          // 成功出队次数
+    size_t full_rejections = 0;   // 因队列满而失败的入队次数
+    size_t empty_polls = 0;       // 因队列空而失败的出队次数
+    size_t max_depth = 0;         // 入队后观测到的最大深度
+};
+
+// 默认统计策略：不统计，钩子均为空函数，编译后与不带统计的队列完全相同
+struct SPSCNoStats {
+    struct Producer {
+        void on_enqueue(size_t) {}
+        void on_enqueue_bulk(size_t, size_t) {}
+        void on_full() {}
+    };
+    
+    struct Consumer {
+        void on_dequeue() {}
+        void on_dequeue_bulk(size_t) {}
+        void on_empty() {}
+    };
+    
+    static SPSCQueueStatsSnapshot snapshot(const Producer&, const Consumer&) {
+        return SPSCQueueStatsSnapshot{};
+    }
+};
+
+// 轻量统计策略：生产者和消费者的计数器分别放在各自的索引所在的缓存行上，
+// 每个计数器只有一个写者，用relaxed的load+store累加而不是fetch_add，
+// 热路径上没有共享写也没有带lock前缀的指令；原子类型只是为了让监控线程能无竞争地读取
+struct SPSCQueueStats {
+    struct Producer {
+        std::atomic<size_t> enqueued{0};
+        std::atomic<size_t> full_rejections{0};
+        std::atomic<size_t> max_depth{0};
+        
+        void on_enqueue(size_t depth) {
+            on_enqueue_bulk(1, depth);
+        }
+        
+        // 一批入队n个，批内深度逐个增加，入队后的final_depth就是其中的最大值
+        void on_enqueue_bulk(size_t n, size_t final_depth) {
+            enqueued.store(enqueued.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            if (final_depth > max_depth.load(std::memory_order_relaxed)) {
+                max_depth.store(final_depth, std::memory_order_relaxed);
+            }
+        }
+        
+        void on_full() {
+            full_rejections.store(full_rejections.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+    
+    struct Consumer {
+        std::atomic<size_t> dequeued{0};
+        std::atomic<size_t> empty_polls{0};
+        
+        void on_dequeue() {
+            on_dequeue_bulk(1);
+        }
+        
+        void on_dequeue_bulk(size_t n) {
+            dequeued.store(dequeued.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+        
+        void on_empty() {
+            empty_polls.store(empty_polls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+    
+    static SPSCQueueStatsSnapshot snapshot(const Producer& producer, const Consumer& consumer) {
+        SPSCQueueStatsSnapshot result;
+        result.enqueued = producer.enqueued.load(std::memory_order_relaxed);
+        result.full_rejections = producer.full_rejections.load(std::memory_order_relaxed);
+        result.max_depth = producer.max_depth.load(std::memory_order_relaxed);
+        result.dequeued = consumer.dequeued.load(std::memory_order_relaxed);
+        result.empty_polls = consumer.empty_polls.load(std::memory_order_relaxed);
+        return result;
+    }
+};
+
+// 默认写入策略：槽位直接赋值；before_publish在发布tail之前调用，
+// 大消息体可换用payload_copy.hpp中的SPSCPayloadWrite（SIMD/流式写入）
+struct SPSCAssignWrite {
+    template<typename T, typename U>
+    static void write(T& slot, U&& item) {
+        slot = std::forward<U>(item);
+    }
+    
+    template<typename T>
+    static void before_publish() {}
+};
+
+// 默认预取策略：不预取
+struct SPSCNoPrefetch {
+    template<size_t Mask, typename T>
+    static void producer(T*, size_t, size_t) {}
+    
+    template<size_t Mask, typename T>
+    static void consumer(const T*, size_t, size_t) {}
+};
+
+// 软件预取策略：消费者每次出队时预取之后第Distance个槽位，生产者每次入队时对之后第Distance个槽位
+// 发出写意图预取（x86上为prefetchw，提前取得缓存行的独占权，省掉写入时的RFO等待）。
+// 只预取已经属于自己的槽位：消费者只预取已发布的元素，生产者只预取空闲槽位，
+// 避免把对方正在读写的缓存行抢过来造成来回迁移。槽位跨多个缓存行时逐行预取
+template<size_t Distance = 4>
+struct SPSCPrefetch {
+    static_assert(Distance > 0, "Distance must be positive");
+    
+    // position为本次写入的槽位，free_slots为从position起的空闲槽位数
+    template<size_t Mask, typename T>
+    static void producer(T* buffer, size_t position, size_t free_slots) {
+        if (Distance < free_slots) {
+            prefetch_slot<1>(&buffer[(position + Distance) & Mask]);
+        }
+    }
+    
+    // position为本次读取的槽位，available为从position起已发布的元素数
+    template<size_t Mask, typename T>
+    static void consumer(const T* buffer, size_t position, size_t available) {
+        if (Distance < available) {
+            prefetch_slot<0>(&buffer[(position + Distance) & Mask]);
+        }
+    }
+
+private:
+    // 槽位不一定按64字节对齐，按槽位首尾字节所在的缓存行取整，跨行的槽位每一行都要预取
+    template<int ReadWrite, typename T>
+    static void prefetch_slot(const T* slot) {
+        const uintptr_t first = reinterpret_cast<uintptr_t>(slot) & ~uintptr_t(63);
+        const uintptr_t last = (reinterpret_cast<uintptr_t>(slot) + sizeof(T) - 1) & ~uintptr_t(63);
+        for (uintptr_t line = first; line <= last; line += 64) {
+            __builtin_prefetch(reinterpret_cast<const void*>(line), ReadWrite, 3);
+        }
+    }
+};
+
+template<typename T, size_t Size, typename Stats = SPSCNoStats, typename Write = SPSCAssignWrite,
+         typename Prefetch = SPSCNoPrefetch>
 class SPSCLockFreeQueue {
     static_assert((Size & (Size - 1)) == 0, "Size must be power of 2");
-    
+
 private:
     struct alignas(64) HeadData {  // 避免false sharing
         std::atomic<size_t> head;
+        typename Stats::Consumer stats;  // 只由消费者写
     } head_data_;
     
     struct alignas(64) TailData {  // 避免false sharing
         std::atomic<size_t> tail;
+        typename Stats::Producer stats;  // 只由生产者写
     } tail_data_;
     
     struct alignas(64) BufferData {
@@ -22,10 +166,12 @@ private:
     } buffer_data_;
     
     static constexpr size_t MASK = Size - 1;
-    
+
 public:
+    using value_type = T;
+    
     SPSCLockFreeQueue() 
-        : head_data_{0}, tail_data_{0} { // 初始化具名结构体成员
+        : head_data_{0, {}}, tail_data_{0, {}} { // 初始化具名结构体成员
     }
     ~SPSCLockFreeQueue() = default;
     
@@ -42,35 +188,91 @@ public:
         const size_t next_tail = (current_tail + 1) & MASK;
         
         // 检查队列是否已满
-        if (next_tail == head_data_.head.load(std::memory_order_acquire)) {
+        const size_t current_head = head_data_.head.load(std::memory_order_acquire);
+        if (next_tail == current_head) {
+            tail_data_.stats.on_full();
             return false;  // 队列已满
         }
         
         // 存储数据
-        buffer_data_.buffer[current_tail] = std::forward<U>(item);
+        Prefetch::template producer<MASK>(buffer_data_.buffer, current_tail, (current_head - current_tail - 1) & MASK);
+        Write::write(buffer_data_.buffer[current_tail], std::forward<U>(item));
+        Write::template before_publish<T>();
         
         // 更新tail指针
         tail_data_.tail.store(next_tail, std::memory_order_release);
+        tail_data_.stats.on_enqueue((next_tail - current_head) & MASK);
         return true;
     }
     
     // 消费者端：出队操作
     bool dequeue(T& item) {
         const size_t current_head = head_data_.head.load(std::memory_order_relaxed);
+        const size_t current_tail = tail_data_.tail.load(std::memory_order_acquire);
         
         // 检查队列是否为空
-        if (current_head == tail_data_.tail.load(std::memory_order_acquire)) {
+        if (current_head == current_tail) {
+            head_data_.stats.on_empty();
             return false;  // 队列为空
         }
         
         // 读取数据
+        Prefetch::template consumer<MASK>(buffer_data_.buffer, current_head, (current_tail - current_head) & MASK);
         item = std::move(buffer_data_.buffer[current_head]);
         
         // 更新head指针
         head_data_.head.store((current_head + 1) & MASK, std::memory_order_release);
+        head_data_.stats.on_dequeue();
         return true;
     }
     
+    // 生产者端：批量入队，返回实际入队数量；整批只读一次head、发布一次tail
+    size_t enqueue_bulk(const T* items, size_t count) {
+        const size_t current_tail = tail_data_.tail.load(std::memory_order_relaxed);
+        const size_t current_head = head_data_.head.load(std::memory_order_acquire);
+        const size_t free_slots = (current_head - current_tail - 1) & MASK;
+        const size_t n = count < free_slots ? count : free_slots;
+        if (n == 0) {
+            if (count > 0) {
+                tail_data_.stats.on_full();  // 只有一个都没写入才算被拒绝，部分写入不计
+            }
+            return 0;
+        }
+        
+        for (size_t i = 0; i < n; ++i) {
+            Prefetch::template producer<MASK>(buffer_data_.buffer, current_tail + i, free_slots - i);
+            Write::write(buffer_data_.buffer[(current_tail + i) & MASK], items[i]);
+        }
+        Write::template before_publish<T>();
+        
+        tail_data_.tail.store((current_tail + n) & MASK, std::memory_order_release);
+        tail_data_.stats.on_enqueue_bulk(n, (current_tail + n - current_head) & MASK);  // 整批只更新一次计数
+        return n;
+    }
+    
+    // 消费者端：批量出队，返回实际出队数量；整批只读一次tail、发布一次head
+    size_t dequeue_bulk(T* items, size_t max_count) {
+        if (max_count == 0) {
+            return 0;  // 不是空轮询，不计入统计
+        }
+        const size_t current_head = head_data_.head.load(std::memory_order_relaxed);
+        const size_t available = (tail_data_.tail.load(std::memory_order_acquire) - current_head) & MASK;
+        const size_t n = max_count < available ? max_count : available;
+        if (n == 0) {
+            head_data_.stats.on_empty();
+            return 0;
+        }
+        
+        for (size_t i = 0; i < n; ++i) {
+            Prefetch::template consumer<MASK>(buffer_data_.buffer, current_head + i, available - i);
+            items[i] = std::move(buffer_data_.buffer[(current_head + i) & MASK]);
+        }
+        
+        head_data_.head.store((current_head + n) & MASK, std::memory_order_release);
+        head_data_.stats.on_dequeue_bulk(n);
+        return n;
+    }
+    
     // 检查队列是否为空
     bool empty() const {
         return head_data_.head.load(std::memory_order_acquire) == tail_data_.tail.load(std::memory_order_acquire);
@@ -94,4 +296,9 @@ public:
     static constexpr size_t capacity() {
         return Size - 1;  // 实际可用容量比Size小1
     }
+    
+    // 读取统计快照，可由任意线程调用；默认策略下恒为全0
+    SPSCQueueStatsSnapshot snapshot() const {
+        return Stats::snapshot(tail_data_.stats, head_data_.stats);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Chase–Lev工作窃取双端队列（内存序按Lê等人2013年的C11版本）
+// 所有者线程在底部push/pop（后进先出），任意线程在顶部steal（先进先出）
+//
+// 元素以原子方式读写，窃取者可能读到正被所有者覆盖的槽位，读出后CAS失败即丢弃，
+// 因此T必须可平凡复制，通常是任务指针或句柄
+//
+// 数组写满时所有者换成两倍大小的新数组；窃取者可能仍在读旧数组，旧数组留到
+// 析构时才释放（延迟回收），历次旧数组合计不超过当前数组大小
+template<typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "ChaseLevDeque requires a trivially copyable T");
+
+private:
+    struct Array {
+        const int64_t size;
+        const int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+        
+        explicit Array(int64_t n) : size(n), mask(n - 1), slots(new std::atomic<T>[static_cast<size_t>(n)]) {}
+        
+        T get(int64_t i) const {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+        
+        void put(int64_t i, T item) {
+            slots[i & mask].store(item, std::memory_order_relaxed);
+        }
+    };
+    
+    alignas(64) std::atomic<int64_t> top_{0};     // 窃取者竞争的一端
+    alignas(64) std::atomic<int64_t> bottom_{0};  // 只由所有者写
+    std::atomic<Array*> array_;
+    
+    std::vector<std::unique_ptr<Array>> arrays_;  // 当前及历次旧数组，只由所有者访问
+    
+    // 所有者：复制[top, bottom)到两倍大小的新数组
+    Array* grow(Array* old, int64_t bottom, int64_t top) {
+        arrays_.push_back(std::make_unique<Array>(old->size * 2));
+        Array* bigger = arrays_.back().get();
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+public:
+    using value_type = T;
+    
+    // 初始容量向上取整到2的幂次
+    explicit ChaseLevDeque(size_t capacity = 1024) {
+        int64_t size = 2;
+        while (size < static_cast<int64_t>(capacity)) size <<= 1;
+        arrays_.push_back(std::make_unique<Array>(size));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+    
+    // 禁止拷贝和移动
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+    ChaseLevDeque(ChaseLevDeque&&) = delete;
+    ChaseLevDeque& operator=(ChaseLevDeque&&) = delete;
+    
+    // 所有者：压入底部，数组满时扩容，不会失败
+    void push(T item) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > array->size - 1) {
+            array = grow(array, bottom, top);
+        }
+        array->put(bottom, item);
+        // 原文为release栅栏加relaxed写，这里直接用release写（x86上同样只是普通mov），
+        // ThreadSanitizer也能识别这一同步关系
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+    
+    // 所有者：从底部弹出最近压入的元素；只剩一个元素时与窃取者竞争
+    bool pop(T& item) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);  // 队列为空
+            return false;
+        }
+        
+        item = array->get(bottom);
+        if (top == bottom) {
+            // 最后一个元素：与窃取者CAS竞争top
+            const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+    
+    // 任意线程：从顶部窃取最早压入的元素；队列为空或与其他线程竞争失败时返回false
+    bool steal(T& item) {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        
+        if (top >= bottom) {
+            return false;  // 队列为空
+        }
+        
+        // 原文为consume，这里用acquire
+        Array* array = array_.load(std::memory_order_acquire);
+        T stolen = array->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;  // 被所有者或其他窃取者抢先
+        }
+        item = stolen;
+        return true;
+    }
+    
+    // 检查队列是否为空（近似值）
+    bool empty() const {
+        return size() == 0;
+    }
+    
+    // 获取当前元素数（近似值）
+    size_t size() const {
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+    
+    // 当前数组容量，扩容后变大
+    size_t capacity() const {
+        return static_cast<size_t>(array_.load(std::memory_order_acquire)->size);
+    }
+};
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "inplace_task.hpp"
+#include "mpmc_bounded_queue.hpp"
+#include "work_stealing_deque.hpp"
+
+namespace executor_detail {
+
+// 线程池中的任务：不超过48字节的可调用对象直接存放，整个任务占一个缓存行
+using Task = InplaceTask<48>;
+
+// 放不进Task的可调用对象先移到堆上，任务里只保存指针
+template<typename F>
+Task make_task(F&& f) {
+    using D = std::decay_t<F>;
+    if constexpr (Task::fits<D>) {
+        return Task(std::forward<F>(f));
+    } else {
+        return Task([boxed = std::make_unique<D>(std::forward<F>(f))]() { (*boxed)(); });
+    }
+}
+
+// 任务槽位：工作线程从自己的槽位数组中分配，任务执行完成后由执行者（可能是窃取者）释放
+struct alignas(64) TaskSlot {
+    Task task;
+    std::atomic<bool> busy{false};
+};
+
+// 在futex上休眠/唤醒；非Linux平台退回短暂睡眠后重新检查
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+inline void futex_wake(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+}  // namespace executor_detail
+
+struct ExecutorStats {
+    size_t executed = 0;     // 执行的任务数
+    size_t stolen = 0;       // 其中从其他工作线程窃取的任务数
+    size_t inline_runs = 0;  // 本地槽位用尽时直接执行的任务数
+    size_t parks = 0;        // 工作线程进入futex休眠的次数
+    size_t wakeups = 0;      // 提交方发起的futex唤醒次数
+};
+
+// 工作窃取线程池
+//
+// 每个工作线程拥有一个Chase–Lev双端队列（本地任务）和一个MPSC收件箱（外部提交）：
+//   - 外部线程submit()时轮流选择工作线程，任务按值写入其收件箱，只唤醒这一个线程
+//   - 任务内部submit()时压入当前线程的双端队列，有线程休眠时唤醒其中一个来窃取
+//   - 工作线程依次检查本地队列、收件箱（取出的任务转入本地队列以便被窃取）、随机窃取，
+//     空转若干轮后在自己的futex字上休眠
+//
+// 休眠与提交之间的竞争：工作线程先写休眠标志再检查收件箱和各队列，提交方先发布任务
+// 再读休眠标志，两边之间各有一个seq_cst栅栏；唤醒方用exchange取走标志，每次休眠只唤醒一次
+//
+// 析构时等待所有已提交的任务执行完毕；析构开始后不能再从外部提交
+class WorkStealingExecutor {
+private:
+    using Task = executor_detail::Task;
+    using TaskSlot = executor_detail::TaskSlot;
+    
+    static constexpr uint32_t kRunning = 0;
+    static constexpr uint32_t kParked = 1;
+    static constexpr int kSpinRounds = 64;      // 休眠前空转的轮数
+    static constexpr size_t kInboxBatch = 16;   // 每次从收件箱取出的最大任务数
+    
+    struct alignas(64) Worker {
+        ChaseLevDeque<TaskSlot*> deque;
+        MPMCBoundedQueue<Task, true, false> inbox;
+        std::unique_ptr<TaskSlot[]> slots;
+        size_t slot_count;
+        size_t slot_cursor = 0;  // 只由所有者访问
+        uint64_t rng;            // 只由所有者访问
+        
+        alignas(64) std::atomic<uint32_t> state{kRunning};
+        
+        // 统计只由所有者写
+        alignas(64) std::atomic<size_t> executed{0};
+        std::atomic<size_t> stolen{0};
+        std::atomic<size_t> inline_runs{0};
+        std::atomic<size_t> parks{0};
+        
+        Worker(size_t local_capacity, size_t inbox_capacity, uint64_t seed)
+            : deque(local_capacity), inbox(inbox_capacity),
+              slots(new TaskSlot[local_capacity]), slot_count(local_capacity), rng(seed) {}
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    
+    alignas(64) std::atomic<size_t> next_worker_{0};  // 外部提交的轮转位置
+    alignas(64) std::atomic<size_t> sleepers_{0};
+    std::atomic<size_t> wakeups_{0};
+    std::atomic<bool> stop_{false};
+    
+    struct Context {
+        WorkStealingExecutor* executor;
+        size_t index;
+    };
+    
+    static Context& current() {
+        static thread_local Context context{nullptr, 0};
+        return context;
+    }
+    
+    static void bump(std::atomic<size_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    // 所有者：从轮转位置找一个空闲槽位，转一整圈都在使用中时返回nullptr
+    static TaskSlot* allocate_slot(Worker& worker) {
+        for (size_t n = 0; n < worker.slot_count; ++n) {
+            TaskSlot* slot = &worker.slots[worker.slot_cursor];
+            worker.slot_cursor = worker.slot_cursor + 1 == worker.slot_count ? 0 : worker.slot_cursor + 1;
+            if (!slot->busy.load(std::memory_order_acquire)) {
+                slot->busy.store(true, std::memory_order_relaxed);
+                return slot;
+            }
+        }
+        return nullptr;
+    }
+    
+    static void run_slot(Worker& self, TaskSlot* slot) {
+        slot->task();
+        slot->task.reset();
+        slot->busy.store(false, std::memory_order_release);
+        bump(self.executed);
+    }
+    
+    // 把任务放入当前工作线程的本地队列，槽位用尽时直接执行
+    void push_local(Worker& self, Task&& task) {
+        TaskSlot* slot = allocate_slot(self);
+        if (slot == nullptr) {
+            task();
+            bump(self.executed);
+            bump(self.inline_runs);
+            return;
+        }
+        slot->task = std::move(task);
+        self.deque.push(slot);
+        wake_any();
+    }
+    
+    // 取走工作线程的休眠标志并唤醒它
+    bool wake(Worker& worker) {
+        if (worker.state.load(std::memory_order_relaxed) != kParked ||
+            worker.state.exchange(kRunning, std::memory_order_relaxed) != kParked) {
+            return false;
+        }
+        executor_detail::futex_wake(worker.state);
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    // 本地队列有新任务：有线程休眠时唤醒其中一个来窃取
+    void wake_any() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_acquire) == 0) {
+            return;  // 常见路径：没有休眠的线程
+        }
+        const size_t n = workers_.size();
+        const size_t start = next_worker_.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < n; ++k) {
+            if (wake(*workers_[(start + k) % n])) return;
+        }
+    }
+    
+    bool try_local(Worker& self) {
+        TaskSlot* slot = nullptr;
+        if (!self.deque.pop(slot)) {
+            return false;
+        }
+        run_slot(self, slot);
+        return true;
+    }
+    
+    // 从收件箱取出一批任务，第一个直接执行，其余转入本地队列供其他线程窃取
+    bool try_inbox(Worker& self) {
+        Task first;
+        if (!self.inbox.dequeue(first)) {
+            return false;
+        }
+        Task task;
+        for (size_t n = 1; n < kInboxBatch && self.inbox.dequeue(task); ++n) {
+            push_local(self, std::move(task));
+        }
+        first();
+        bump(self.executed);
+        return true;
+    }
+    
+    bool try_steal(size_t index) {
+        Worker& self = *workers_[index];
+        const size_t n = workers_.size();
+        if (n == 1) {
+            return false;
+        }
+        uint64_t& x = self.rng;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const size_t start = static_cast<size_t>(x % n);
+        TaskSlot* slot = nullptr;
+        for (size_t k = 0; k < n; ++k) {
+            const size_t victim = (start + k) % n;
+            if (victim != index && workers_[victim]->deque.steal(slot)) {
+                run_slot(self, slot);
+                bump(self.stolen);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // 休眠前最后检查一次是否有可做的工作
+    bool has_work(const Worker& self) const {
+        if (!self.inbox.empty()) return true;
+        for (const auto& worker : workers_) {
+            if (!worker->deque.empty()) return true;
+        }
+        return false;
+    }
+    
+    void park(Worker& self) {
+        self.state.store(kParked, std::memory_order_relaxed);
+        sleepers_.fetch_add(1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        
+        if (!has_work(self) && !stop_.load(std::memory_order_relaxed)) {
+            bump(self.parks);
+            while (self.state.load(std::memory_order_acquire) == kParked) {
+                executor_detail::futex_wait(self.state, kParked);
+            }
+        }
+        // 撤销登记；提交方若已取走标志，会多一次futex唤醒，不影响正确性
+        self.state.store(kRunning, std::memory_order_relaxed);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    // 成功时取走task，失败时task保持不变
+    bool submit_task(Task& task) {
+        Context& context = current();
+        if (context.executor == this) {
+            push_local(*workers_[context.index], std::move(task));
+            return true;
+        }
+        
+        const size_t n = workers_.size();
+        const size_t start = next_worker_.fetch_add(1, std::memory_order_relaxed);
+        for (size_t k = 0; k < n; ++k) {
+            Worker& worker = *workers_[(start + k) % n];
+            if (worker.inbox.enqueue(std::move(task))) {  // 队列满时不会移动task
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                wake(worker);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void worker_loop(size_t index) {
+        current() = Context{this, index};
+        Worker& self = *workers_[index];
+        int idle = 0;
+        while (true) {
+            if (try_local(self) || try_inbox(self) || try_steal(index)) {
+                idle = 0;
+                continue;
+            }
+            // 自己的队列和收件箱都已取空，其他线程的任务由其所有者负责
+            if (stop_.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (++idle < kSpinRounds) {
+                std::this_thread::yield();
+                continue;
+            }
+            park(self);
+            idle = 0;
+        }
+        current() = Context{nullptr, 0};
+    }
+
+public:
+    // local_capacity：每个工作线程的本地任务槽位数；inbox_capacity：每个收件箱的容量
+    explicit WorkStealingExecutor(size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+                                  size_t local_capacity = 1024, size_t inbox_capacity = 1024) {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>(local_capacity, inbox_capacity,
+                                                        0x9E3779B97F4A7C15ULL * (i + 1)));
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+    
+    ~WorkStealingExecutor() {
+        stop_.store(true, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto& worker : workers_) {
+            wake(*worker);
+        }
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+    
+    // 禁止拷贝和移动
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor(WorkStealingExecutor&&) = delete;
+    WorkStealingExecutor& operator=(WorkStealingExecutor&&) = delete;
+    
+    // 提交任务；在工作线程内调用时压入本地队列，否则写入某个工作线程的收件箱
+    // 所有收件箱都已满时返回false，可调用对象随之销毁
+    template<typename F>
+    bool try_submit(F&& f) {
+        Task task = executor_detail::make_task(std::forward<F>(f));
+        return submit_task(task);
+    }
+    
+    // 提交任务，所有收件箱都满时让出CPU后重试
+    template<typename F>
+    void submit(F&& f) {
+        Task task = executor_detail::make_task(std::forward<F>(f));
+        while (!submit_task(task)) {
+            std::this_thread::yield();
+        }
+    }
+    
+    size_t size() const {
+        return workers_.size();
+    }
+    
+    // 各工作线程统计之和（近似值）
+    ExecutorStats stats() const {
+        ExecutorStats s;
+        for (const auto& worker : workers_) {
+            s.executed += worker->executed.load(std::memory_order_relaxed);
+            s.stolen += worker->stolen.load(std::memory_order_relaxed);
+            s.inline_runs += worker->inline_runs.load(std::memory_order_relaxed);
+            s.parks += worker->parks.load(std::memory_order_relaxed);
+        }
+        s.wakeups = wakeups_.load(std::memory_order_relaxed);
+        return s;
+    }
+};